@@ -0,0 +1,33 @@
+#include "bench.hpp"
+#include "../src/modules/analytics.hpp"
+#include <random>
+
+// Custo por tick do estágio de análise (EWMA, perda, mínimo noturno, travamento)
+HYDRO_BENCHMARK("fleet", analytics_tick) {
+    std::vector<int> sizes = ctx.meterCounts();
+    sizes.push_back(1000000);
+
+    for (int n : sizes) {
+        std::vector<float> flowIN(n);
+        std::vector<float> flowOUT(n);
+        std::vector<int32_t> counter(n);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> flow(0.0f, 0.015f);
+        for (int i = 0; i < n; ++i) {
+            flowIN[i] = flow(rng);
+            flowOUT[i] = flowIN[i] * 0.9f;
+            counter[i] = i;
+        }
+
+        FleetAnalytics analytics(n);
+        std::vector<AnalyticsAlert> alerts;
+        float secondsOfDay = 0.0f;
+        ctx.measure("analytics.tick/meters=" + std::to_string(n), n, "meter_ticks", [&]() {
+            alerts.clear();
+            // Avança o relógio para percorrer também a janela noturna
+            secondsOfDay += 60.0f;
+            if (secondsOfDay >= 86400.0f) secondsOfDay = 0.0f;
+            analytics.tick(flowIN.data(), flowOUT.data(), counter.data(), 0.1f, secondsOfDay, alerts);
+        });
+    }
+}
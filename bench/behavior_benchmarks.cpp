@@ -0,0 +1,93 @@
+#include "bench.hpp"
+#include "../src/modules/behavior.hpp"
+#include <chrono>
+#include <memory>
+
+namespace {
+
+// Alvo que só conta manobras: isola o custo do escalonador
+class CountingTarget : public BehaviorTarget {
+public:
+    float getMaxFlow(uint32_t) const override { return 0.001f; }
+    void setFlowRate(uint32_t, float flow) override { this->sum += flow; }
+    void activate(uint32_t) override { ++this->toggles; }
+    void deactivate(uint32_t) override { ++this->toggles; }
+    void advance(uint64_t) override {}
+
+    double sum = 0.0;
+    uint64_t toggles = 0;
+};
+
+double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// 1M comportamentos torneira+vazamento suspensos: memória por comportamento,
+// criação e retomadas/s ao longo de 1 hora virtual
+HYDRO_BENCHMARK("fleet", behavior_scheduler) {
+    const uint32_t behaviors = 1000000;
+    const std::string name = "fleet.behavior_scheduler/behaviors=" + std::to_string(behaviors);
+    CountingTarget target;
+    auto scheduler = std::make_unique<BehaviorScheduler>(target);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < behaviors; ++i) scheduler->spawn(i, tapCycle, TapCycleConfig());
+    double spawnMs = millisSince(start);
+
+    scheduler->run(std::chrono::hours(1));
+    BehaviorStats stats = scheduler->getStats();
+    doNotOptimize(target.sum);
+
+    ctx.report(name, "spawn", spawnMs, "ms");
+    ctx.report(name, "frame_bytes", static_cast<double>(stats.frameBytes) / stats.live, "bytes/behavior");
+    ctx.report(name, "timer_bytes", static_cast<double>(stats.timerBytes) / stats.live, "bytes/behavior");
+    ctx.report(name, "resumes_per_s", stats.resumes / stats.seconds, "resumes/s");
+    ctx.report(name, "virtual_speedup", 3600.0 / stats.seconds, "x");
+}
+
+// Frota em lote de 100k hidrômetros dirigida pelos comportamentos por 1 dia virtual
+HYDRO_BENCHMARK("fleet", behavior_fleet_day) {
+    const uint32_t meters = 100000;
+    const std::string name = "fleet.behavior_fleet_day/meters=" + std::to_string(meters);
+    StandardFleet fleet;
+    fleet.reserve(meters);
+    for (uint32_t i = 0; i < meters; ++i) fleet.add(i % StandardFleet::MODEL_COUNT, 0, false);
+
+    FleetBehaviorTarget target(fleet);
+    BehaviorScheduler scheduler(target);
+    for (uint32_t i = 0; i < meters; ++i) scheduler.spawn(i, tapCycle, TapCycleConfig());
+    scheduler.run(std::chrono::hours(24));
+    BehaviorStats stats = scheduler.getStats();
+    doNotOptimize(fleet.getSnapshot(0).counter);
+
+    ctx.report(name, "elapsed", stats.seconds * 1000.0, "ms");
+    ctx.report(name, "commands_per_s", stats.commands / stats.seconds, "commands/s");
+    ctx.report(name, "virtual_speedup", 86400.0 / stats.seconds, "x");
+}
+
+// Mesma frota com manobras de inércia de primeira ordem (tau = 2 s): os
+// volume dos hidrômetros em rampa vem de FlowDynamics, integrado até a
+// manobra seguinte
+HYDRO_BENCHMARK("fleet", behavior_flow_dynamics) {
+    const uint32_t meters = 10000;
+    const std::string name = "fleet.behavior_flow_dynamics/meters=" + std::to_string(meters);
+    StandardFleet fleet;
+    fleet.reserve(meters);
+    for (uint32_t i = 0; i < meters; ++i) fleet.add(i % StandardFleet::MODEL_COUNT, 0, false);
+
+    FleetBehaviorTarget target(fleet);
+    target.enableFlowDynamics();
+    BehaviorScheduler scheduler(target);
+    for (uint32_t i = 0; i < meters; ++i) scheduler.spawn(i, tapCycle, TapCycleConfig());
+    scheduler.run(std::chrono::hours(1));
+    BehaviorStats stats = scheduler.getStats();
+    doNotOptimize(fleet.getSnapshot(0).counter);
+
+    const double steps = static_cast<double>(target.getFlowDynamics()->getStepCount());
+    ctx.report(name, "elapsed", stats.seconds * 1000.0, "ms");
+    ctx.report(name, "steps_per_meter_hour", steps / meters, "steps");
+    ctx.report(name, "ns_per_step", stats.seconds * 1e9 / steps, "ns");
+    ctx.report(name, "virtual_speedup", 3600.0 / stats.seconds, "x");
+}
@@ -0,0 +1,108 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Harness mínimo de benchmarks do simulador.
+// Cada resultado é emitido como uma linha JSON (JSON Lines) para que as
+// execuções de diferentes releases possam ser comparadas automaticamente.
+
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    // Medições de vazão (measure)
+    long long iterations = 0;
+    double seconds = 0.0;
+    double itemsPerOp = 0.0;
+    std::string itemUnit;
+    // Métricas avulsas (report): RSS, latência, etc.
+    std::string metric;
+    double value = 0.0;
+    std::string unit;
+};
+
+class BenchContext {
+public:
+    BenchContext(const std::string& suite, double minTime, const std::vector<int>& meters);
+
+    // Repete op até acumular minTime segundos e registra ns/op e itens/s.
+    // itemsPerOp indica quantas unidades (ex.: meter-ticks) cada chamada processa.
+    template <typename Op>
+    void measure(const std::string& name, double itemsPerOp, const std::string& itemUnit, Op&& op) {
+        using Clock = std::chrono::steady_clock;
+        long long n = 1;
+        double elapsed = 0.0;
+        for (;;) {
+            auto start = Clock::now();
+            for (long long i = 0; i < n; ++i) {
+                op();
+            }
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            if (elapsed >= this->minTime || n >= (1LL << 40)) break;
+            // Estima quantas iterações faltam para atingir minTime (no máximo 10x)
+            double factor = elapsed > 0.0 ? (this->minTime * 1.2) / elapsed : 10.0;
+            if (factor > 10.0) factor = 10.0;
+            if (factor < 2.0) factor = 2.0;
+            n = static_cast<long long>(n * factor);
+        }
+        BenchResult r;
+        r.suite = this->suite;
+        r.name = name;
+        r.iterations = n;
+        r.seconds = elapsed;
+        r.itemsPerOp = itemsPerOp;
+        r.itemUnit = itemUnit;
+        this->results.push_back(r);
+    }
+
+    void report(const std::string& name, const std::string& metric, double value, const std::string& unit);
+
+    const std::vector<int>& meterCounts() const { return this->meters; }
+    const std::vector<BenchResult>& getResults() const { return this->results; }
+
+private:
+    std::string suite;
+    double minTime;
+    std::vector<int> meters;
+    std::vector<BenchResult> results;
+};
+
+using BenchFn = void (*)(BenchContext&);
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* suite, const char* name, BenchFn fn);
+};
+
+// Impede que o compilador descarte o resultado de uma operação medida
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Descarta a saída de std::cout enquanto estiver no escopo (os módulos logam
+// no terminal e o stdout do benchmark é reservado para o JSON).
+class ScopedSilence {
+public:
+    ScopedSilence() : previous(std::cout.rdbuf(&sink)) {}
+    ~ScopedSilence() { std::cout.rdbuf(previous); }
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+    NullBuffer sink;
+    std::streambuf* previous;
+};
+
+#define HYDRO_BENCHMARK(suite, fn)                                  \
+    static void fn(BenchContext& ctx);                              \
+    static BenchRegistrar fn##_registrar(suite, #fn, fn);           \
+    static void fn(BenchContext& ctx)
+
+#endif // BENCH_H
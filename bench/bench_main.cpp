@@ -0,0 +1,156 @@
+#include "bench.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+struct BenchEntry {
+    const char* suite;
+    const char* name;
+    BenchFn fn;
+};
+
+std::vector<BenchEntry>& registry() {
+    static std::vector<BenchEntry> entries;
+    return entries;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::string toJson(const BenchResult& r, const std::string& version) {
+    std::ostringstream js;
+    js.precision(6);
+    js << "{\"version\":\"" << jsonEscape(version) << "\""
+       << ",\"suite\":\"" << jsonEscape(r.suite) << "\""
+       << ",\"name\":\"" << jsonEscape(r.name) << "\""
+       << ",\"threads\":" << std::thread::hardware_concurrency();
+    if (r.metric.empty()) {
+        double nsPerOp = r.seconds * 1e9 / r.iterations;
+        double itemsPerSec = r.itemsPerOp * r.iterations / r.seconds;
+        js << ",\"iterations\":" << r.iterations
+           << ",\"seconds\":" << r.seconds
+           << ",\"ns_per_op\":" << nsPerOp
+           << ",\"ops_per_sec\":" << (r.iterations / r.seconds)
+           << ",\"items_per_op\":" << r.itemsPerOp
+           << ",\"items_per_sec\":" << itemsPerSec
+           << ",\"item\":\"" << jsonEscape(r.itemUnit) << "\"";
+    } else {
+        js << ",\"metric\":\"" << jsonEscape(r.metric) << "\""
+           << ",\"value\":" << r.value
+           << ",\"unit\":\"" << jsonEscape(r.unit) << "\"";
+    }
+    js << "}";
+    return js.str();
+}
+
+void printHuman(const BenchResult& r) {
+    char line[256];
+    if (r.metric.empty()) {
+        double nsPerOp = r.seconds * 1e9 / r.iterations;
+        double itemsPerSec = r.itemsPerOp * r.iterations / r.seconds;
+        snprintf(line, sizeof(line), "%-8s %-44s %14.1f ns/op %16.1f %s/s",
+                 r.suite.c_str(), r.name.c_str(), nsPerOp, itemsPerSec, r.itemUnit.c_str());
+    } else {
+        snprintf(line, sizeof(line), "%-8s %-44s %14.3f %s (%s)",
+                 r.suite.c_str(), r.name.c_str(), r.value, r.unit.c_str(), r.metric.c_str());
+    }
+    std::cerr << line << std::endl;
+}
+
+std::vector<int> parseList(const char* arg) {
+    std::vector<int> values;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(std::atoi(item.c_str()));
+    }
+    return values;
+}
+
+void usage(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--filter texto] [--min-time s] [--meters N,N,...]\n"
+              << "       [--version id] [--out arquivo.jsonl] [--list]\n";
+}
+
+} // namespace
+
+BenchContext::BenchContext(const std::string& suite, double minTime, const std::vector<int>& meters)
+    : suite(suite), minTime(minTime), meters(meters) {}
+
+void BenchContext::report(const std::string& name, const std::string& metric, double value, const std::string& unit) {
+    BenchResult r;
+    r.suite = this->suite;
+    r.name = name;
+    r.metric = metric;
+    r.value = value;
+    r.unit = unit;
+    this->results.push_back(r);
+}
+
+BenchRegistrar::BenchRegistrar(const char* suite, const char* name, BenchFn fn) {
+    registry().push_back({suite, name, fn});
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string version = "unknown";
+    std::string outPath;
+    double minTime = 0.2;
+    std::vector<int> meters = {100, 1000};
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--filter") && hasValue) filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && hasValue) minTime = std::atof(argv[++i]);
+        else if (!strcmp(argv[i], "--meters") && hasValue) meters = parseList(argv[++i]);
+        else if (!strcmp(argv[i], "--version") && hasValue) version = argv[++i];
+        else if (!strcmp(argv[i], "--out") && hasValue) outPath = argv[++i];
+        else if (!strcmp(argv[i], "--list")) listOnly = true;
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    // Resultados são anexados ao arquivo para manter o histórico entre releases
+    std::ofstream out;
+    if (!outPath.empty()) {
+        out.open(outPath, std::ios::app);
+        if (!out) {
+            std::cerr << "[ERROR] Não foi possível abrir " << outPath << std::endl;
+            return 1;
+        }
+    }
+
+    for (const BenchEntry& entry : registry()) {
+        std::string fullName = std::string(entry.suite) + "/" + entry.name;
+        if (!filter.empty() && fullName.find(filter) == std::string::npos) continue;
+        if (listOnly) {
+            std::cout << fullName << std::endl;
+            continue;
+        }
+
+        BenchContext ctx(entry.suite, minTime, meters);
+        entry.fn(ctx);
+        for (const BenchResult& r : ctx.getResults()) {
+            std::string line = toJson(r, version);
+            std::cout << line << std::endl;
+            if (out) out << line << '\n';
+            printHuman(r);
+        }
+    }
+    return 0;
+}
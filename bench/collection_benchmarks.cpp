@@ -0,0 +1,53 @@
+#include "bench.hpp"
+#include "../src/modules/collection.hpp"
+#include <chrono>
+
+namespace {
+
+const char* BENCH_SOCKET = "/tmp/hydrometer_bench_headend.sock";
+
+void reportCollection(BenchContext& ctx, const std::string& name, const CollectionStats& stats) {
+    ctx.report(name, "readings_per_s", stats.readingsPerSecond, "readings/s");
+    ctx.report(name, "cycle_latency_p50", stats.latencyP50Ms, "ms");
+    ctx.report(name, "cycle_latency_p99", stats.latencyP99Ms, "ms");
+    ctx.report(name, "bytes_per_reading", static_cast<double>(stats.bytes) / stats.readings, "bytes");
+}
+
+} // namespace
+
+// Coleta de 1M hidrômetros em 64 rotas pelo socket do head-end local:
+// capacidade (ciclos sem intervalo, todos vencidos) e ciclos agendados a
+// cada 1 s com início escalonado
+HYDRO_BENCHMARK("fleet", collection_cycle) {
+    ScopedSilence silence;
+    const uint32_t meters = 1000000;
+    StandardFleet fleet;
+    fleet.reserve(meters);
+    for (uint32_t i = 0; i < meters; ++i) fleet.add(i % StandardFleet::MODEL_COUNT, static_cast<int32_t>(i % 1000000), true);
+
+    SnapshotPublisher publisher;
+    auto start = std::chrono::steady_clock::now();
+    publisher.publish(fleet, 0);
+    double publishMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    HeadEndServer headEnd;
+    if (!headEnd.start(BENCH_SOCKET)) return;
+
+    CollectionConfig config;
+    config.socketPath = BENCH_SOCKET;
+    config.routes = 64;
+
+    const std::string base = "fleet.collection_cycle/meters=" + std::to_string(meters);
+    config.cycles = 3;
+    config.cyclePeriodMs = 0;
+    CollectionEmulator saturated(config, publisher);
+    if (saturated.run()) reportCollection(ctx, base + ",mode=capacity", saturated.getStats());
+
+    config.cycles = 2;
+    config.cyclePeriodMs = 1000;
+    CollectionEmulator paced(config, publisher);
+    if (paced.run()) reportCollection(ctx, base + ",mode=paced_1s", paced.getStats());
+
+    ctx.report(base, "snapshot_publish", publishMs, "ms");
+    headEnd.stop();
+}
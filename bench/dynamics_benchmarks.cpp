@@ -0,0 +1,37 @@
+#include "bench.hpp"
+#include "../src/modules/flow_dynamics.hpp"
+#include "../src/modules/meter_model.hpp"
+#include <random>
+
+// Uma hora simulada por operação: leituras a 1 Hz e, em média, uma manobra de
+// válvula por hidrômetro a cada 15 minutos. Compara os passos do integrador
+// adaptativo com os 36000 passos/hora do tick fixo de 0.1 s.
+HYDRO_BENCHMARK("fleet", flow_dynamics_hour) {
+    const float maxFlow = Residential15::GEOMETRY.in.maxFlow;
+    for (int n : ctx.meterCounts()) {
+        FlowDynamics dynamics(n);
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> opening(0.0f, 0.6f);
+        std::uniform_int_distribution<int> when(0, 900 - 1);
+        double now = 0.0;
+        double hours = 0.0;
+
+        ctx.measure("flow_dynamics.hour/meters=" + std::to_string(n), n, "meter_hours", [&]() {
+            for (int s = 0; s < 3600; ++s) {
+                now += 1.0;
+                // ~n/900 manobras por segundo
+                for (int e = when(rng); e < n; e += 900) {
+                    dynamics.setTarget(static_cast<uint32_t>(e), maxFlow * opening(rng), now);
+                }
+                dynamics.advanceTo(now);
+            }
+            hours += 1.0;
+        });
+
+        double stepsPerMeterHour = dynamics.getStepCount() / (hours * n);
+        ctx.report("flow_dynamics.steps_per_meter_hour/meters=" + std::to_string(n),
+                   "steps", stepsPerMeterHour, "steps/meter-hour");
+        ctx.report("flow_dynamics.work_vs_fixed_tick/meters=" + std::to_string(n),
+                   "ratio", stepsPerMeterHour / 36000.0, "x");
+    }
+}
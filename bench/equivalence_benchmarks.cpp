@@ -0,0 +1,23 @@
+#include "bench.hpp"
+#include "../src/modules/equivalence.hpp"
+#include <sstream>
+
+// Vazão do verificador de equivalência (referência + frota em lote +
+// comparação a cada tick) e tempo de um cenário de 1M hidrômetros
+HYDRO_BENCHMARK("fleet", equivalence_check) {
+    EquivalenceConfig config;
+    config.ticks = 100;
+    for (uint32_t meters : {100000u, 1000000u}) {
+        config.meters = meters;
+        EquivalenceChecker checker(config);
+        std::ostringstream out;
+        bool passed = checker.run(out);
+        const EquivalenceSummary& summary = checker.getSummary();
+
+        const std::string name = "fleet.equivalence_check/meters=" + std::to_string(meters) +
+                                 ",ticks=" + std::to_string(config.ticks);
+        ctx.report(name, "meter_ticks_per_s", summary.meterTicks / summary.seconds, "meter-ticks/s");
+        ctx.report(name, "elapsed", summary.seconds * 1000.0, "ms");
+        ctx.report(name, "divergent_meters", static_cast<double>(passed ? 0 : summary.divergentMeters), "meters");
+    }
+}
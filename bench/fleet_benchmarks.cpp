@@ -0,0 +1,79 @@
+#include "bench.hpp"
+#include "../src/modules/fleet.hpp"
+#include "../src/modules/hidrometer.hpp"
+#include "../src/utils/image.hpp"
+#include <memory>
+#include <thread>
+
+#define BENCH_IMAGE_PATH "/tmp/hydrometer_bench/"
+
+namespace {
+
+// Cria uma frota de n hidrômetros e para as threads internas em paralelo
+// (shutdown() sequencial esperaria o sleep de cada thread, um por vez).
+std::unique_ptr<Hidrometer[]> makeQuiescedFleet(int n) {
+    auto fleet = std::make_unique<Hidrometer[]>(n);
+    std::vector<std::thread> stoppers;
+    stoppers.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        stoppers.emplace_back([&fleet, i]() { fleet[i].shutdown(); });
+    }
+    for (auto& t : stoppers) t.join();
+
+    for (int i = 0; i < n; ++i) {
+        fleet[i].activate();
+        Pipe* in = fleet[i].getPipeIN();
+        // Vazões variadas entre 10% e 90% do máximo
+        in->setFlowRate(in->getMaxFlow() * (0.1f + 0.8f * (i % 9) / 8.0f));
+    }
+    return fleet;
+}
+
+} // namespace
+
+// Um tick da frota = update() em todos os hidrômetros (meter-ticks/s)
+HYDRO_BENCHMARK("fleet", fleet_tick) {
+    ScopedSilence silence;
+    for (int n : ctx.meterCounts()) {
+        auto fleet = makeQuiescedFleet(n);
+        ctx.measure("fleet.tick/meters=" + std::to_string(n), n, "meter_ticks", [&]() {
+            for (int i = 0; i < n; ++i) {
+                fleet[i].update();
+            }
+        });
+    }
+}
+
+// Geração de imagens como em Simulator::imageUpdateLoop, percorrendo a frota (images/s)
+HYDRO_BENCHMARK("fleet", fleet_images) {
+    ScopedSilence silence;
+    const int n = 16;
+    auto fleet = makeQuiescedFleet(n);
+    Image image;
+    int next = 0;
+    ctx.measure("fleet.images/meters=" + std::to_string(n), 1, "images", [&]() {
+        Hidrometer& meter = fleet[next];
+        meter.update();
+        // Contador módulo 1 m³: um arquivo por hidrômetro, sobrescrito a cada volta
+        image.generate_image(next, meter.getCounter() % 1000, meter.getPipeIN()->getFlowRate(),
+                             meter.getPipeIN()->getMaxFlow(), BENCH_IMAGE_PATH);
+        next = (next + 1) % n;
+    });
+}
+
+// Frota em lote mista (R15/R20/C50): um kernel especializado por modelo (meter-ticks/s)
+HYDRO_BENCHMARK("fleet", fleet_batched_tick) {
+    std::vector<int> counts = ctx.meterCounts();
+    counts.push_back(1000000);
+    for (int n : counts) {
+        StandardFleet fleet;
+        for (int i = 0; i < n; ++i) {
+            uint32_t id = 0;
+            fleet.add(static_cast<size_t>(i % StandardFleet::MODEL_COUNT), 0, true, &id);
+            fleet.setFlowRate(id, fleet.getMaxFlow(id) * (0.1f + 0.8f * (i % 9) / 8.0f));
+        }
+        ctx.measure("fleet.batched_tick/meters=" + std::to_string(n), n, "meter_ticks", [&]() {
+            fleet.tick();
+        });
+    }
+}
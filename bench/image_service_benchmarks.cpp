@@ -0,0 +1,99 @@
+#include "bench.hpp"
+#include "../src/modules/image_service.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+
+namespace {
+
+const char* SOCKET_PATH = "/tmp/hydrometer_bench_images.sock";
+
+// Frota sintética com leituras estáveis (o cenário de polling repetido)
+ImageService::ReadingProvider syntheticProvider(uint32_t meters) {
+    return [meters](uint32_t meter, MeterSnapshot& snapshot, float& maxFlow) {
+        if (meter >= meters) return false;
+        snapshot = MeterSnapshot{1u, 0.0002f * (meter % 50), 0.00018f * (meter % 50), static_cast<int32_t>(meter * 37), 0u};
+        maxFlow = Residential15::GEOMETRY.in.maxFlow;
+        return true;
+    };
+}
+
+int connectTo(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Um pedido completo: envia "GET id" e lê o cabeçalho e o PNG
+bool request(int fd, uint32_t meter, std::string& buffer) {
+    std::string line = "GET " + std::to_string(meter) + "\n";
+    if (send(fd, line.data(), line.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(line.size())) return false;
+
+    buffer.clear();
+    size_t expected = std::string::npos;
+    char chunk[65536];
+    while (expected == std::string::npos || buffer.size() < expected) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+        size_t newline = buffer.find('\n');
+        if (expected == std::string::npos && newline != std::string::npos) {
+            if (buffer.compare(0, 3, "OK ") != 0) return false;
+            expected = newline + 1 + std::stoul(buffer.substr(3, newline - 3));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// Quadro atual de um hidrômetro: cache LRU vs render + codificação a cada pedido
+HYDRO_BENCHMARK("fleet", image_service_frame) {
+    const uint32_t meters = 1000;
+    for (bool cached : {true, false}) {
+        ImageServiceConfig config;
+        config.cacheBytes = cached ? config.cacheBytes : 0;
+        ImageService service(syntheticProvider(meters), config);
+        uint32_t next = 0;
+        ctx.measure(std::string("image_service.frame/") + (cached ? "cached" : "uncached"), 1.0, "frames", [&]() {
+            Frame frame = service.getFrame(next);
+            doNotOptimize(frame);
+            next = next + 1 == meters ? 0 : next + 1;
+        });
+        if (cached) {
+            FrameCacheStats stats = service.getCacheStats();
+            ctx.report("image_service.frame/cached", "hit_ratio",
+                       static_cast<double>(stats.hits) / (stats.hits + stats.misses), "ratio");
+        }
+    }
+}
+
+// Pedido completo pelo socket Unix (cliente persistente, leituras em cache)
+HYDRO_BENCHMARK("fleet", image_service_socket) {
+    ScopedSilence silence;
+    const uint32_t meters = 1000;
+    ImageService service(syntheticProvider(meters));
+    if (!service.start(SOCKET_PATH)) return;
+    int fd = connectTo(SOCKET_PATH);
+    if (fd < 0) return;
+
+    std::string buffer;
+    uint32_t next = 0;
+    bool ok = true;
+    ctx.measure("image_service.socket/cached", 1.0, "requests", [&]() {
+        ok = request(fd, next, buffer) && ok;
+        next = next + 1 == meters ? 0 : next + 1;
+    });
+    close(fd);
+    service.stop();
+    if (!ok) ctx.report("image_service.socket/cached", "errors", 1.0, "flag");
+}
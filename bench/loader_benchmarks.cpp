@@ -0,0 +1,81 @@
+#include "bench.hpp"
+#include "../src/modules/fleet_loader.hpp"
+#include "../src/modules/hidrometer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sys/stat.h>
+#include <thread>
+
+namespace {
+
+const char* BENCH_DIR = "/tmp/hydrometer_bench";
+
+// Arquivo de definição sintético: modelos pré-definidos em rodízio e ~1% de
+// hidrômetros com uma entre 64 geometrias arbitrárias
+std::string writeFleetFile(size_t meters) {
+    mkdir(BENCH_DIR, 0755);
+    std::string path = std::string(BENCH_DIR) + "/fleet_" + std::to_string(meters) + ".csv";
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && info.st_size > 0) return path;
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return "";
+    std::fputs("id,modelo,contador,status\n", file);
+    for (size_t i = 0; i < meters; ++i) {
+        unsigned id = static_cast<unsigned>(100000 + i);
+        int counter = static_cast<int>((i * 7919) % 1000000);
+        int status = (i % 10) != 0;
+        if (i % 100 == 99) {
+            size_t g = (i / 100) % 64;
+            std::fprintf(file, "%u,%.4f/%.3f/0.00005,%d,%d\n", id, 0.015 + 0.0005 * g, 0.15 + 0.002 * g, counter, status);
+        } else {
+            std::fprintf(file, "%u,%s,%d,%d\n", id, StandardFleet::modelName(i % StandardFleet::MODEL_COUNT), counter, status);
+        }
+    }
+    std::fclose(file);
+    return path;
+}
+
+double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// Carga em massa de 1M hidrômetros (alvo de inicialização: <= 100 ms)
+HYDRO_BENCHMARK("startup", fleet_load) {
+    const size_t n = 1000000;
+    std::string path = writeFleetFile(n);
+    if (path.empty()) return;
+    const std::string name = "startup.fleet_load/meters=" + std::to_string(n);
+
+    // Primeira carga aquece o cache de páginas; a melhor de 3 é reportada
+    double best = 0.0;
+    FleetLoadStats stats;
+    for (int run = 0; run < 4; ++run) {
+        StandardFleet fleet;
+        std::vector<uint32_t> ids;
+        if (!FleetLoader().load(path, fleet, ids, &stats)) return;
+        doNotOptimize(fleet.size());
+        if (run == 1 || (run > 1 && stats.totalMs < best)) best = stats.totalMs;
+    }
+    ctx.report(name, "startup", best, "ms");
+    ctx.report(name, "meters_per_s", n / (best / 1000.0), "meters/s");
+    ctx.report(name, "geometry_solves", static_cast<double>(stats.geometrySolves), "solves");
+    ctx.report(name, "threads", stats.threads, "threads");
+}
+
+// Referência: construir Hidrometers um a um (extrapolado de 100 para 1M)
+HYDRO_BENCHMARK("startup", hidrometer_construct) {
+    ScopedSilence silence;
+    const size_t n = 100;
+    auto start = std::chrono::steady_clock::now();
+    auto meters = std::make_unique<Hidrometer[]>(n);
+    double elapsed = millisSince(start);
+    ctx.report("startup.hidrometer_construct/meters=1000000", "startup_extrapolated", elapsed * (1000000.0 / n), "ms");
+
+    std::vector<std::thread> stoppers;
+    for (size_t i = 0; i < n; ++i) stoppers.emplace_back([&meters, i]() { meters[i].shutdown(); });
+    for (auto& t : stoppers) t.join();
+}
@@ -0,0 +1,69 @@
+#include "bench.hpp"
+#include "../src/modules/fleet.hpp"
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// RSS e tamanho virtual atuais do processo (bytes), via /proc/self/statm
+bool readMemory(size_t& rss, size_t& virt) {
+    std::ifstream statm("/proc/self/statm");
+    size_t pagesVirt = 0, pagesRss = 0;
+    if (!(statm >> pagesVirt >> pagesRss)) return false;
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    rss = pagesRss * page;
+    virt = pagesVirt * page;
+    return true;
+}
+
+void reportPerMeter(BenchContext& ctx, const std::string& name, size_t meters,
+                    size_t rss0, size_t virt0, size_t rss1, size_t virt1) {
+    double rss = rss1 > rss0 ? static_cast<double>(rss1 - rss0) : 0.0;
+    double virt = virt1 > virt0 ? static_cast<double>(virt1 - virt0) : 0.0;
+    ctx.report(name + "/meters=" + std::to_string(meters), "rss", rss, "bytes");
+    ctx.report(name + "/meters=" + std::to_string(meters), "rss_per_meter", rss / meters, "bytes/meter");
+    ctx.report(name + "/meters=" + std::to_string(meters), "virtual_per_meter", virt / meters, "bytes/meter");
+}
+
+} // namespace
+
+// Frota compacta (alvo: 12 bytes por hidrômetro, sem threads) com 1M e 10M hidrômetros
+HYDRO_BENCHMARK("memory", fleet_rss) {
+    for (size_t n : {size_t(1000000), size_t(10000000)}) {
+        size_t rss0, virt0, rss1, virt1;
+        if (!readMemory(rss0, virt0)) return;
+        {
+            StandardFleet fleet;
+            fleet.reserve(n);
+            fleet.reserve<Residential15>(n / 3 + 1);
+            fleet.reserve<Residential20>(n / 3 + 1);
+            fleet.reserve<Commercial50>(n / 3 + 1);
+            for (size_t i = 0; i < n; ++i) {
+                fleet.add(i % StandardFleet::MODEL_COUNT, static_cast<int32_t>(i % 1000), true);
+            }
+            fleet.tick();
+            readMemory(rss1, virt1);
+            reportPerMeter(ctx, "memory.fleet", n, rss0, virt0, rss1, virt1);
+            ctx.report("memory.fleet/meters=" + std::to_string(n), "reserved_per_meter",
+                       static_cast<double>(fleet.memoryBytes()) / n, "bytes/meter");
+        }
+    }
+}
+
+// Referência: Hidrometer com dois Pipes no heap, atomics e uma std::thread cada
+HYDRO_BENCHMARK("memory", hidrometer_rss) {
+    ScopedSilence silence;
+    const size_t n = 1000;
+    size_t rss0, virt0, rss1, virt1;
+    if (!readMemory(rss0, virt0)) return;
+    auto meters = std::make_unique<Hidrometer[]>(n);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    readMemory(rss1, virt1);
+    reportPerMeter(ctx, "memory.hidrometer", n, rss0, virt0, rss1, virt1);
+
+    std::vector<std::thread> stoppers;
+    for (size_t i = 0; i < n; ++i) stoppers.emplace_back([&meters, i]() { meters[i].shutdown(); });
+    for (auto& t : stoppers) t.join();
+}
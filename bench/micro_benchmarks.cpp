@@ -0,0 +1,139 @@
+#include "bench.hpp"
+#include "../src/modules/hidrometer.hpp"
+#include "../src/modules/pipe.hpp"
+#include "../src/utils/image.hpp"
+#include "../src/utils/logger.hpp"
+#include <atomic>
+#include <sys/stat.h>
+#include <thread>
+
+#define BENCH_IMAGE_PATH "/tmp/hydrometer_bench/"
+
+// Solução iterativa de Darcy-Weisbach usada no construtor de Pipe
+HYDRO_BENCHMARK("micro", pipe_maxFlowForDeltaP) {
+    Pipe pipe(DIAMETER_IN, LENGTH_IN, ROUGHNESS_IN);
+    double deltaP = 1000000.0;
+    ctx.measure("pipe.maxFlowForDeltaP", 1, "solves", [&]() {
+        double q = pipe.maxFlowForDeltaP(deltaP);
+        doNotOptimize(q);
+    });
+}
+
+// Construção de Pipe: solução em tempo de execução vs vazão máxima constexpr
+HYDRO_BENCHMARK("micro", pipe_construct) {
+    ctx.measure("pipe.construct.runtime_solve", 1, "pipes", [&]() {
+        Pipe pipe(DIAMETER_IN, LENGTH_IN, ROUGHNESS_IN);
+        doNotOptimize(pipe.getMaxFlow());
+    });
+    constexpr PipeGeometry geometry = Residential15::GEOMETRY.in;
+    ctx.measure("pipe.construct.constexpr_model", 1, "pipes", [&]() {
+        Pipe pipe(geometry.diameter, geometry.length, geometry.roughness, geometry.maxFlow);
+        doNotOptimize(pipe.getMaxFlow());
+    });
+}
+
+HYDRO_BENCHMARK("micro", pipe_setFlowRate) {
+    Pipe pipe(DIAMETER_IN, LENGTH_IN, ROUGHNESS_IN);
+    float step = pipe.getMaxFlow() / 50.0f;
+    float flow = 0.0f;
+    ctx.measure("pipe.setFlowRate", 1, "calls", [&]() {
+        flow += step;
+        if (flow > pipe.getMaxFlow()) flow = 0.0f;
+        pipe.setFlowRate(flow);
+    });
+}
+
+// Passo de integração de um hidrômetro ativo, com a thread interna parada
+HYDRO_BENCHMARK("micro", hidrometer_update) {
+    ScopedSilence silence;
+    Hidrometer meter;
+    meter.shutdown();
+    meter.activate();
+    meter.getPipeIN()->setFlowRate(meter.getPipeIN()->getMaxFlow() * 0.5f);
+    ctx.measure("hidrometer.update", 1, "meter_ticks", [&]() {
+        meter.update();
+    });
+}
+
+// Leitura do snapshot versionado, sem e com um escritor atualizando em laço
+HYDRO_BENCHMARK("micro", hidrometer_getSnapshot) {
+    ScopedSilence silence;
+    Hidrometer meter;
+    meter.shutdown();
+    meter.activate();
+    meter.getPipeIN()->setFlowRate(meter.getPipeIN()->getMaxFlow() * 0.5f);
+    meter.update();
+
+    ctx.measure("hidrometer.getSnapshot", 1, "reads", [&]() {
+        MeterSnapshot snap = meter.getSnapshot();
+        doNotOptimize(snap.counter);
+    });
+
+    std::atomic<bool> writing(true);
+    std::thread writer([&]() {
+        while (writing.load(std::memory_order_relaxed)) meter.update();
+    });
+    ctx.measure("hidrometer.getSnapshot.contended", 1, "reads", [&]() {
+        MeterSnapshot snap = meter.getSnapshot();
+        doNotOptimize(snap.counter);
+    });
+    writing.store(false);
+    writer.join();
+}
+
+// Desenho do mostrador sem gravação em disco
+HYDRO_BENCHMARK("micro", image_render) {
+    Image image;
+    Pipe pipe(DIAMETER_IN, LENGTH_IN, ROUGHNESS_IN);
+    int counter = 0;
+    ctx.measure("image.render", 1, "frames", [&]() {
+        image.render(counter++, pipe.getMaxFlow() * 0.4f, pipe.getMaxFlow());
+    });
+}
+
+// Codificação PNG + escrita (cairo_surface_write_to_png) de uma superfície pronta
+HYDRO_BENCHMARK("micro", image_write_to_png) {
+    Image image;
+    Pipe pipe(DIAMETER_IN, LENGTH_IN, ROUGHNESS_IN);
+    mkdir(BENCH_IMAGE_PATH, 0755);
+    image.render(12345, pipe.getMaxFlow() * 0.4f, pipe.getMaxFlow());
+    std::string path = std::string(BENCH_IMAGE_PATH) + "write_to_png.png";
+    ctx.measure("image.cairo_surface_write_to_png", 1, "frames", [&]() {
+        image.save(path);
+    });
+}
+
+// Caminho completo usado pelo simulador (diretório + render + PNG)
+HYDRO_BENCHMARK("micro", image_generate_image) {
+    Image image;
+    Pipe pipe(DIAMETER_IN, LENGTH_IN, ROUGHNESS_IN);
+    int counter = 0;
+    // Leituras abaixo de 1 m³: o nome do arquivo (Hidrometro_0_0.jpeg) não
+    // muda e cada iteração sobrescreve o mesmo PNG
+    ctx.measure("image.generate_image", 1, "frames", [&]() {
+        image.generate_image(0, counter, pipe.getMaxFlow() * 0.4f, pipe.getMaxFlow(), BENCH_IMAGE_PATH);
+        counter = (counter + 7) % 1000;
+    });
+}
+
+HYDRO_BENCHMARK("micro", logger_log) {
+    ScopedSilence silence;
+    Logger::setRuntimeMode(true);
+    Logger::setDebugMode(false);
+
+    // Mensagem DEBUG descartada em modo runtime (caso mais comum no laço)
+    ctx.measure("logger.log.filtered", 1, "messages", [&]() {
+        Logger::log(LogLevel::DEBUG, "[DEBUG] Pipe::setFlowRate - Vazão máxima atingida");
+    });
+
+    // Mensagem efetivamente escrita (stdout descartado)
+    ctx.measure("logger.log.emitted", 1, "messages", [&]() {
+        Logger::log(LogLevel::RUNTIME, "[INFO] Hidrómetro status: Active");
+    });
+
+    ctx.measure("logger.logRuntime", 1, "frames", [&]() {
+        Logger::logRuntime("ATIVO", 0.0012f, 0.00108f, 123456, 0);
+    });
+
+    Logger::setRuntimeMode(false);
+}
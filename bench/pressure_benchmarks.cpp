@@ -0,0 +1,87 @@
+#include "bench.hpp"
+#include "../src/modules/pressure_flow.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+
+const std::vector<PipeGeometry> BENCH_MODELS = {Residential15::GEOMETRY.in, Residential20::GEOMETRY.in,
+                                                Commercial50::GEOMETRY.in};
+
+// Frota mista com pressões em torno de 300 kPa e aberturas variadas
+PressureFlowSolver makeSolver(int n, const PressureFlowConfig& config) {
+    std::vector<uint16_t> meterModel(n);
+    for (int i = 0; i < n; ++i) meterModel[i] = static_cast<uint16_t>(i % BENCH_MODELS.size());
+    PressureFlowSolver solver(BENCH_MODELS, meterModel, config);
+    for (int i = 0; i < n; ++i) {
+        solver.setSupplyPressure(i, 300000.0f);
+        solver.setOpening(i, 0.2f + 0.8f * (i % 5) / 4.0f);
+    }
+    solver.solve();
+    return solver;
+}
+
+// Um tick: pressão da rede oscila com amplitude relativa swing e ~1% das
+// válvulas é manobrada
+void driveTick(PressureFlowSolver& solver, int n, int tick, float swing, std::mt19937& rng) {
+    float pressure = 300000.0f * (1.0f + swing * std::sin(tick * 0.01f));
+    solver.setSupplyPressureAll(pressure);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    std::uniform_real_distribution<float> opening(0.1f, 1.0f);
+    for (int k = 0; k < n / 100 + 1; ++k) solver.setOpening(pick(rng), opening(rng));
+}
+
+void runCase(BenchContext& ctx, const std::string& label, const PressureFlowConfig& config, float swing) {
+    for (int n : ctx.meterCounts()) {
+        PressureFlowSolver solver = makeSolver(n, config);
+        std::mt19937 rng(5);
+        int tick = 0;
+        uint64_t solves0 = solver.getSolveCount();
+        uint64_t iterations0 = solver.getIterationCount();
+        ctx.measure("pressure_flow.tick." + label + "/meters=" + std::to_string(n), n, "meter_ticks", [&]() {
+            driveTick(solver, n, tick++, swing, rng);
+            solver.solve();
+        });
+        uint64_t solves = solver.getSolveCount() - solves0;
+        uint64_t iterations = solver.getIterationCount() - iterations0;
+        ctx.report("pressure_flow.iterations_per_solve." + label + "/meters=" + std::to_string(n), "iterations",
+                   solves ? static_cast<double>(iterations) / solves : 0.0, "iterations/solve");
+        ctx.report("pressure_flow.solved_fraction." + label + "/meters=" + std::to_string(n), "fraction",
+                   tick ? static_cast<double>(solves) / (static_cast<double>(tick) * n) : 0.0, "solves/meter_tick");
+    }
+}
+
+} // namespace
+
+// Solução a frio a cada tick (V = 1.0, sem tolerância) vs warm start + pulo por
+// tolerância, com a rede oscilando 5% e com a rede estável (variação < tolerância)
+HYDRO_BENCHMARK("fleet", pressure_flow_tick) {
+    PressureFlowConfig cold;
+    cold.warmStart = false;
+    cold.pressureTol = 0.0f;
+    cold.openingTol = 0.0f;
+    runCase(ctx, "cold", cold, 0.05f);
+    runCase(ctx, "warm", PressureFlowConfig(), 0.05f);
+    runCase(ctx, "warm_steady", PressureFlowConfig(), 0.00005f);
+}
+
+// Tick completo da frota dirigida por pressão: solução, aplicação das vazões
+// com Fleet::setFlowRate e tick do lote, com a rede oscilando 5%
+HYDRO_BENCHMARK("fleet", pressure_driven_fleet_tick) {
+    for (int n : ctx.meterCounts()) {
+        StandardFleet fleet;
+        for (int i = 0; i < n; ++i) fleet.add(i % StandardFleet::MODEL_COUNT, 0, true);
+        PressureDrivenFleet driven(fleet);
+        for (int i = 0; i < n; ++i) driven.setOpening(i, 0.2f + 0.8f * (i % 5) / 4.0f);
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        std::uniform_real_distribution<float> opening(0.1f, 1.0f);
+        int tick = 0;
+        ctx.measure("pressure_driven_fleet.tick/meters=" + std::to_string(n), n, "meter_ticks", [&]() {
+            driven.setSupplyPressureAll(300000.0f * (1.0f + 0.05f * std::sin(tick++ * 0.01f)));
+            for (int k = 0; k < n / 100 + 1; ++k) driven.setOpening(pick(rng), opening(rng));
+            driven.tick();
+        });
+        doNotOptimize(fleet.getSnapshot(0).counter);
+    }
+}
@@ -0,0 +1,73 @@
+#include "bench.hpp"
+#include "../src/modules/rollup.hpp"
+#include <random>
+
+namespace {
+
+const int64_t BENCH_EPOCH = 1700006400; // 2023-11-15 00:00 UTC
+
+// Rollup de n hidrômetros (8 regiões) alimentado com 90 dias de leituras horárias
+ConsumptionRollup makeRollup(int n, std::vector<int32_t>& counters, int64_t& now) {
+    std::vector<uint32_t> groups(n);
+    for (int i = 0; i < n; ++i) groups[i] = i % 8;
+    ConsumptionRollup rollup(groups, 8);
+    counters.assign(n, 0);
+    now = BENCH_EPOCH;
+    for (int h = 0; h < 90 * 24; ++h) {
+        for (int i = 0; i < n; ++i) counters[i] += (i * 7 + h) % 40;
+        rollup.recordAll(counters.data(), now);
+        now += 3600;
+    }
+    return rollup;
+}
+
+} // namespace
+
+// Atualização incremental dos baldes a cada leitura da frota
+HYDRO_BENCHMARK("fleet", rollup_record) {
+    for (int n : ctx.meterCounts()) {
+        std::vector<int32_t> counters;
+        int64_t now;
+        ConsumptionRollup rollup = makeRollup(n, counters, now);
+        ctx.measure("rollup.recordAll/meters=" + std::to_string(n), n, "readings", [&]() {
+            for (int i = 0; i < n; ++i) counters[i] += 3;
+            now += 60;
+            rollup.recordAll(counters.data(), now);
+        });
+    }
+}
+
+// Consultas de janela arbitrária e top-K
+HYDRO_BENCHMARK("fleet", rollup_query) {
+    for (int n : ctx.meterCounts()) {
+        std::vector<int32_t> counters;
+        int64_t now;
+        ConsumptionRollup rollup = makeRollup(n, counters, now);
+        std::mt19937 rng(7);
+        const int64_t days = (now - BENCH_EPOCH) / 86400;
+
+        ctx.measure("rollup.meterConsumption/meters=" + std::to_string(n), 1, "queries", [&]() {
+            int64_t start = BENCH_EPOCH + static_cast<int64_t>(rng() % days) * 86400;
+            int64_t liters = 0;
+            rollup.meterConsumption(rng() % n, start, now, liters);
+            doNotOptimize(liters);
+        });
+
+        ctx.measure("rollup.groupConsumption/meters=" + std::to_string(n), 1, "queries", [&]() {
+            int64_t liters = 0;
+            rollup.groupConsumption(rng() % 8, now - 3 * 86400 - 5 * 3600, now, liters);
+            doNotOptimize(liters);
+        });
+
+        ctx.measure("rollup.topConsumers10/meters=" + std::to_string(n), n, "meters_scanned", [&]() {
+            auto top = rollup.topConsumers(10, now - 30 * 86400, now);
+            doNotOptimize(top.size());
+        });
+
+        ctx.measure("rollup.topConsumers10Group/meters=" + std::to_string(n), n / 8, "meters_scanned", [&]() {
+            auto top = rollup.topConsumers(10, now - 30 * 86400, now, rng() % 8);
+            doNotOptimize(top.size());
+        });
+    }
+    ctx.report("rollup.bytesPerMeter", "memory", ConsumptionRollup(std::vector<uint32_t>(1, 0), 1).bytesPerMeter(), "bytes");
+}
@@ -0,0 +1,62 @@
+#include "bench.hpp"
+#include "../src/modules/hidrometer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+double microsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// Latência de parada de uma frota de Hidrometers (uma thread cada): todas as
+// esperas são acordadas de uma vez e os joins não aguardam o período de 100 ms
+HYDRO_BENCHMARK("fleet", hidrometer_stop) {
+    ScopedSilence silence;
+    for (size_t n : {size_t(100), size_t(1000)}) {
+        auto meters = std::make_unique<Hidrometer[]>(n);
+        for (size_t i = 0; i < n; ++i) meters[i].activate();
+        // Garante que as threads já estão na espera entre updates
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i) meters[i].requestShutdown();
+        for (size_t i = 0; i < n; ++i) meters[i].shutdown();
+        double elapsed = microsSince(start);
+
+        const std::string name = "fleet.hidrometer_stop/meters=" + std::to_string(n);
+        ctx.report(name, "stop_latency", elapsed / 1000.0, "ms");
+        ctx.report(name, "stop_per_meter", elapsed / n, "us/meter");
+    }
+}
+
+// Tempo entre uma mudança de controle (deactivate/activate) e sua publicação
+// no snapshot, sem esperar o próximo update
+HYDRO_BENCHMARK("fleet", hidrometer_control_latency) {
+    ScopedSilence silence;
+    Hidrometer meter;
+    meter.activate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+    std::vector<double> samples;
+    for (int trial = 0; trial < 200; ++trial) {
+        bool active = trial % 2 != 0;
+        auto start = std::chrono::steady_clock::now();
+        if (active) meter.activate();
+        else meter.deactivate();
+        while ((meter.getSnapshot().status != 0) != active) {
+            std::this_thread::yield();
+        }
+        samples.push_back(microsSince(start));
+    }
+    meter.shutdown();
+
+    std::sort(samples.begin(), samples.end());
+    ctx.report("fleet.hidrometer_control_latency", "p50", samples[samples.size() / 2], "us");
+    ctx.report("fleet.hidrometer_control_latency", "p99", samples[samples.size() * 99 / 100], "us");
+}
@@ -0,0 +1,24 @@
+#include "bench.hpp"
+#include "../src/modules/sweep.hpp"
+#include <sstream>
+
+// Vazão de cenários da varredura Monte Carlo (5 hidrômetros, 60 s virtuais):
+// um cenário por operação em uma thread e a varredura completa em todos os núcleos
+HYDRO_BENCHMARK("fleet", sweep_scenarios) {
+    SweepConfig config;
+    config.virtualSeconds = 60.0;
+    MonteCarloSweep sweep(config);
+    uint32_t index = 0;
+    ctx.measure("sweep.scenario/virtual_s=60", 1, "scenarios", [&]() {
+        ScenarioResult r = sweep.runScenario(index++);
+        doNotOptimize(r.counterErrorPct);
+    });
+
+    config.scenarios = 2000;
+    config.progressSeconds = 1e9;
+    MonteCarloSweep parallel(config);
+    std::ostringstream sink;
+    parallel.run(sink);
+    ctx.report("sweep.parallel/scenarios=2000/virtual_s=60", "throughput",
+               parallel.getScenariosPerSecond(), "scenarios/s");
+}
@@ -0,0 +1,73 @@
+#include "bench.hpp"
+#include "../src/modules/hidrometer.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Espera (ativamente) o próximo tick publicado pelo hidrômetro
+Clock::time_point waitForTick(const Hidrometer& meter, uint32_t& ticks) {
+    uint32_t start = meter.getSnapshot().ticks;
+    while ((ticks = meter.getSnapshot().ticks) == start) {
+    }
+    return Clock::now();
+}
+
+} // namespace
+
+// Deriva da grade de ticks e atraso em relação aos prazos absolutos, com os
+// núcleos disputados por threads ocupadas (carga) e 20 hidrômetros ativos
+HYDRO_BENCHMARK("fleet", hidrometer_tick_clock) {
+    ScopedSilence silence;
+    const size_t meters = 20;
+    const int windowTicks = 20;
+
+    std::atomic<bool> loaded(true);
+    std::vector<std::thread> load;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned c = 0; c < cores; ++c) {
+        load.emplace_back([&loaded]() {
+            while (loaded.load(std::memory_order_relaxed)) {
+            }
+        });
+    }
+
+    auto fleet = std::make_unique<Hidrometer[]>(meters);
+    for (size_t i = 0; i < meters; ++i) {
+        fleet[i].activate();
+        fleet[i].getPipeIN()->setFlowRate(fleet[i].getPipeIN()->getMaxFlow() / 2.0f);
+    }
+
+    // Janela de windowTicks ticks medida no relógio de parede
+    uint32_t firstTick = 0, lastTick = 0;
+    Clock::time_point first = waitForTick(fleet[0], firstTick);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100 * windowTicks - 50));
+    Clock::time_point last = waitForTick(fleet[0], lastTick);
+
+    loaded.store(false);
+    for (std::thread& t : load) t.join();
+
+    TickHistogram histogram;
+    for (size_t i = 0; i < meters; ++i) {
+        fleet[i].requestShutdown();
+    }
+    for (size_t i = 0; i < meters; ++i) {
+        fleet[i].shutdown();
+        histogram.merge(fleet[i].getTickHistogram());
+    }
+
+    double window = std::chrono::duration<double, std::milli>(last - first).count();
+    double nominal = 100.0 * (lastTick - firstTick);
+    const std::string name = "fleet.hidrometer_tick_clock/meters=" + std::to_string(meters);
+    ctx.report(name, "grid_drift", window - nominal, "ms");
+    ctx.report(name, "grid_drift_per_tick", (window - nominal) * 1000.0 / (lastTick - firstTick), "us/tick");
+    ctx.report(name, "lateness_p50", static_cast<double>(histogram.percentileUs(0.50)), "us");
+    ctx.report(name, "lateness_p99", static_cast<double>(histogram.percentileUs(0.99)), "us");
+    ctx.report(name, "lateness_max", static_cast<double>(histogram.maxLatenessUs), "us");
+    ctx.report(name, "overruns", static_cast<double>(histogram.overruns), "ticks");
+}
@@ -1,34 +1,424 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <cerrno>
+#include <cmath>
 #include <csignal>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <poll.h>
+#include <sys/signalfd.h>
 #include <termios.h>
 #include <unistd.h>
 #include "src/modules/simulator.hpp"
+#include "src/modules/sweep.hpp"
+#include "src/modules/fleet_loader.hpp"
+#include "src/modules/equivalence.hpp"
+#include "src/modules/behavior.hpp"
+#include "src/modules/collection.hpp"
+#include "src/modules/pressure_flow.hpp"
 #include "src/utils/logger.hpp"
 
-// Variável global para controlar finalização
-Simulator* globalSimulator = nullptr;
+// Ctrl+C chega por signalfd e é tratado na thread principal, fora do
+// contexto de sinal (o Logger e stop() não são async-signal-safe).
+// Deve ser chamado antes de criar threads para que todas herdem a máscara.
+int blockInterruptSignal() {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) {
+        return -1;
+    }
+    return signalfd(-1, &mask, SFD_CLOEXEC);
+}
 
-// Handler para Ctrl+C
-void signalHandler(int signal) {
-    if (signal == SIGINT && globalSimulator != nullptr) {
+// Espera ESC (fim da simulação) ou Ctrl+C sem polling periódico
+void waitForShutdown(const Simulator& simulator, int interruptFd) {
+    struct pollfd fds[2] = {{simulator.getStopFd(), POLLIN, 0}, {interruptFd, POLLIN, 0}};
+    int count = interruptFd >= 0 ? 2 : 1;
+    while (poll(fds, count, -1) < 0 && errno == EINTR) {
+    }
+    if (count == 2 && (fds[1].revents & POLLIN)) {
+        struct signalfd_siginfo info;
+        ssize_t bytes = read(interruptFd, &info, sizeof(info));
+        (void)bytes;
         Logger::log(LogLevel::SHUTDOWN, "\n[INFO] Ctrl+C detectado - Finalizando...");
-        globalSimulator->stop();
-        
-        // Restaura terminal
-        struct termios term;
-        tcgetattr(STDIN_FILENO, &term);
-        term.c_lflag |= (ICANON | ECHO | ISIG);
-        tcsetattr(STDIN_FILENO, TCSANOW, &term);
-        
-        exit(0);
     }
 }
 
-int main() {
-    // Configura handler para Ctrl+C
-    signal(SIGINT, signalHandler);
+void printUsage(const char* prog) {
+    std::cout << "Uso: " << prog << " [--shm [nome]] [--image-socket [caminho]]" << std::endl;
+    std::cout << "           [--pin-tick CPUs] [--pin-render CPUs] [--pin-input CPUs]" << std::endl;
+    std::cout << "     " << prog << " --fleet arquivo [--threads T]" << std::endl;
+    std::cout << "     " << prog << " --sweep N [--sweep-seconds S] [--threads T] [--seed X] [--sweep-out arquivo]" << std::endl;
+    std::cout << "     " << prog << " --equiv N [--equiv-ticks T] [--equiv-every K] [--equiv-engine E] [--threads T] [--seed X]" << std::endl;
+    std::cout << "     " << prog << " --behaviors N [--behavior-days D] [--flow-tau S] [--threads T] [--seed X]" << std::endl;
+    std::cout << "     " << prog << " --pressure N [--pressure-hours H] [--seed X]" << std::endl;
+    std::cout << "     " << prog << " --collect N [--routes R] [--collect-cycles C] [--collect-period MS] [--threads T]" << std::endl;
+    std::cout << "  --shm [nome]         publica o estado da frota em memória compartilhada (padrão: "
+              << SHARED_FLEET_DEFAULT_NAME << ")" << std::endl;
+    std::cout << "  --image-socket [caminho]" << std::endl;
+    std::cout << "                       serve a imagem atual de cada hidrômetro (\"GET <id>\") em um" << std::endl;
+    std::cout << "                       socket Unix (padrão: " << IMAGE_SERVICE_DEFAULT_PATH << ")" << std::endl;
+    std::cout << "  --pin-tick CPUs      fixa as threads dos hidrômetros nas CPUs (ex.: 2 ou 2-3,6)" << std::endl;
+    std::cout << "  --pin-render CPUs    fixa a geração e o serviço de imagens nas CPUs" << std::endl;
+    std::cout << "  --pin-input CPUs     fixa a thread de entrada nas CPUs" << std::endl;
+    std::cout << "  --fleet arquivo      carrega uma frota em massa (id,modelo,contador,status) e" << std::endl;
+    std::cout << "                       informa o tempo de carga e a composição" << std::endl;
+    std::cout << "  --sweep N            executa N cenários Monte Carlo em tempo virtual, sem terminal," << std::endl;
+    std::cout << "                       e grava estatísticas em JSON Lines (stdout ou --sweep-out)" << std::endl;
+    std::cout << "  --sweep-seconds S    duração virtual de cada cenário (padrão: 3600)" << std::endl;
+    std::cout << "  --equiv N            compara a frota em lote com Hidrometer::update em N hidrômetros" << std::endl;
+    std::cout << "                       e relata divergências em JSON Lines (saída 0 se equivalentes)" << std::endl;
+    std::cout << "  --equiv-ticks T      ticks de 0.1 s por hidrômetro (padrão: 600)" << std::endl;
+    std::cout << "  --equiv-every K      compara os snapshots a cada K ticks (padrão: 1)" << std::endl;
+    std::cout << "  --equiv-engine E     caminho verificado: fleet (tick a tick) ou behavior" << std::endl;
+    std::cout << "                       (integração preguiçosa do modo --behaviors) (padrão: fleet)" << std::endl;
+    std::cout << "  --behaviors N        roda o comportamento torneira+vazamento (corrotinas) em N" << std::endl;
+    std::cout << "                       hidrômetros em tempo virtual e resume o consumo" << std::endl;
+    std::cout << "  --behavior-days D    dias virtuais; o vazamento começa na metade (padrão: 1)" << std::endl;
+    std::cout << "  --flow-tau S         manobras com inércia de primeira ordem (constante de tempo S s)" << std::endl;
+    std::cout << "                       em vez do degrau de Pipe::setFlowRate" << std::endl;
+    std::cout << "  --pressure N         frota de N hidrômetros com a vazão resolvida a cada tick pela" << std::endl;
+    std::cout << "                       pressão de alimentação e abertura das válvulas" << std::endl;
+    std::cout << "  --pressure-hours H   horas virtuais (padrão: 1)" << std::endl;
+    std::cout << "  --collect N          emula ciclos de coleta de leituras de N hidrômetros, enviados em" << std::endl;
+    std::cout << "                       lotes a um head-end local (" << HEAD_END_DEFAULT_PATH << ")" << std::endl;
+    std::cout << "  --routes R           rotas de leitura (padrão: 16)" << std::endl;
+    std::cout << "  --collect-cycles C   ciclos por rota (padrão: 5)" << std::endl;
+    std::cout << "  --collect-period MS  intervalo entre ciclos de uma rota (padrão: 1000)" << std::endl;
+    std::cout << "  --threads T          threads de trabalho (padrão: todos os núcleos)" << std::endl;
+    std::cout << "  --seed X             semente base dos cenários (padrão: 1)" << std::endl;
+}
+
+// Modo varredura: não cria o Simulator, não toca no terminal nem usa o Logger
+int runSweep(const SweepConfig& config, const std::string& outPath) {
+    MonteCarloSweep sweep(config);
+    if (outPath.empty()) {
+        return sweep.run(std::cout) ? 0 : 1;
+    }
+
+    std::ofstream out(outPath, std::ios::app);
+    if (!out) {
+        std::cerr << "[ERROR] Não foi possível abrir " << outPath << std::endl;
+        return 1;
+    }
+    return sweep.run(out) ? 0 : 1;
+}
+
+// Histograma de atraso dos ticks em relação aos prazos absolutos
+void logTickReport(const TickHistogram& histogram) {
+    if (histogram.ticks == 0) return;
+    Logger::log(LogLevel::SHUTDOWN, "[INFO] Ticks: " + std::to_string(histogram.ticks) +
+                ", atraso médio " + std::to_string(histogram.sumLatenessUs / histogram.ticks) +
+                " µs, p50 ≤ " + std::to_string(histogram.percentileUs(0.50)) +
+                " µs, p99 ≤ " + std::to_string(histogram.percentileUs(0.99)) +
+                " µs, máx " + std::to_string(histogram.maxLatenessUs) +
+                " µs, overruns " + std::to_string(histogram.overruns));
+    for (size_t b = 0; b < TickHistogram::BUCKETS; ++b) {
+        if (histogram.counts[b] == 0) continue;
+        Logger::log(LogLevel::SHUTDOWN, "[INFO]   " + TickHistogram::bucketLabel(b) + ": " + std::to_string(histogram.counts[b]));
+    }
+}
+
+// Modo carga de frota: carrega o arquivo, resume a frota e sai
+int runFleetLoad(const std::string& path, unsigned threads) {
+    Logger::setDebugMode(true);
+    StandardFleet fleet;
+    std::vector<uint32_t> meterIds;
+    FleetLoadStats stats;
+    if (!FleetLoader(threads).load(path, fleet, meterIds, &stats)) {
+        return 1;
+    }
+
+    Logger::log(LogLevel::STARTUP, "[INFO] Frota carregada de " + path + ": " + std::to_string(stats.meters) +
+                " hidrômetros em " + std::to_string(stats.totalMs) + " ms (" + std::to_string(stats.threads) +
+                " threads, interpretação " + std::to_string(stats.parseMs) + " ms, montagem " +
+                std::to_string(stats.buildMs) + " ms)");
+    for (size_t m = 0; m <= StandardFleet::MODEL_COUNT; ++m) {
+        Logger::log(LogLevel::STARTUP, std::string("[INFO]   ") + StandardFleet::modelName(m) + ": " +
+                    std::to_string(stats.perModel[m]));
+    }
+    Logger::log(LogLevel::STARTUP, "[INFO] Geometrias distintas: " + std::to_string(stats.uniqueGeometries) +
+                " (" + std::to_string(stats.geometrySolves) + " soluções), linhas inválidas: " +
+                std::to_string(stats.invalidLines) + ", memória da frota: " +
+                std::to_string(fleet.memoryBytes() / 1024) + " KiB");
+    return stats.meters > 0 ? 0 : 1;
+}
+
+// Modo verificação de equivalência: JSON Lines em stdout, sem o Simulator
+int runEquivalence(EquivalenceConfig config, const std::string& engine, const SweepConfig& shared) {
+    config.threads = shared.threads;
+    config.seed = shared.seed;
+    EngineFactory factory;
+    if (engine == "behavior") {
+        factory = []() { return std::make_unique<BehaviorTargetEngine>(); };
+    } else if (engine != "fleet") {
+        Logger::log(LogLevel::STARTUP, "[ERROR] --equiv-engine desconhecido: " + engine);
+        return 1;
+    }
+    EquivalenceChecker checker(config, factory);
+    return checker.run(std::cout) ? 0 : 1;
+}
+
+// Modo comportamentos: frota em lote dirigida por corrotinas em tempo virtual
+int runBehaviors(uint32_t meters, double days, float flowTau, const SweepConfig& shared) {
+    Logger::setDebugMode(true);
+    StandardFleet fleet;
+    fleet.reserve(meters);
+    for (uint32_t i = 0; i < meters; ++i) {
+        fleet.add(i % StandardFleet::MODEL_COUNT, 0, false);
+    }
+
+    FleetBehaviorTarget target(fleet);
+    if (flowTau > 0.0f) {
+        FlowDynamicsConfig dynamics;
+        dynamics.tau = flowTau;
+        target.enableFlowDynamics(dynamics);
+    }
+    BehaviorSchedulerConfig config;
+    config.threads = shared.threads;
+    config.seed = shared.seed;
+    BehaviorScheduler scheduler(target, config);
+
+    const BehaviorTicks duration = std::chrono::duration_cast<BehaviorTicks>(std::chrono::duration<double, std::ratio<86400>>(days));
+    TapCycleConfig tap;
+    tap.leakAfter = duration / 2;
+    for (uint32_t i = 0; i < meters; ++i) {
+        scheduler.spawn(i, tapCycle, tap);
+    }
+
+    auto totalLiters = [&fleet]() {
+        int64_t liters = 0;
+        for (uint32_t i = 0; i < fleet.size(); ++i) liters += fleet.getSnapshot(i).counter;
+        return liters;
+    };
+    scheduler.run(tap.leakAfter);
+    int64_t beforeLeak = totalLiters();
+    scheduler.run(duration - tap.leakAfter);
+    int64_t afterLeak = totalLiters() - beforeLeak;
+
+    BehaviorStats stats = scheduler.getStats();
+    Logger::log(LogLevel::STARTUP, "[INFO] Comportamentos: " + std::to_string(stats.live) + " em " +
+                std::to_string(days) + " dias virtuais, " + std::to_string(stats.seconds) + " s (" +
+                std::to_string(static_cast<uint64_t>(stats.resumes / stats.seconds)) + " retomadas/s, " +
+                std::to_string(stats.commands) + " manobras)");
+    Logger::log(LogLevel::STARTUP, "[INFO] Memória: " + std::to_string(stats.frameBytes / std::max<uint64_t>(1, stats.live)) +
+                " bytes de quadro por comportamento, roda de temporizadores " + std::to_string(stats.timerBytes / 1024) + " KiB");
+    Logger::log(LogLevel::STARTUP, "[INFO] Consumo: " + std::to_string(beforeLeak) + " L antes do vazamento, " +
+                std::to_string(afterLeak) + " L depois");
+    if (const FlowDynamics* dynamics = target.getFlowDynamics()) {
+        Logger::log(LogLevel::STARTUP, "[INFO] Dinâmica de vazão (tau " + std::to_string(flowTau) + " s): " +
+                    std::to_string(dynamics->getStepCount()) + " passos, " +
+                    std::to_string(dynamics->getRejectedCount()) + " rejeitados");
+    }
+    return 0;
+}
+
+// Modo pressão: frota em lote com a vazão de cada hidrômetro resolvida a cada
+// tick a partir da pressão de alimentação (ciclo diário de ±10% em torno de
+// 300 kPa) e da abertura da válvula (1% das válvulas manobradas por minuto)
+int runPressure(uint32_t meters, double hours, const SweepConfig& shared) {
+    Logger::setDebugMode(true);
+    StandardFleet fleet;
+    fleet.reserve(meters);
+    for (uint32_t i = 0; i < meters; ++i) {
+        fleet.add(i % StandardFleet::MODEL_COUNT, 0, true);
+    }
+
+    PressureDrivenFleet driven(fleet);
+    std::mt19937_64 rng(shared.seed);
+    std::uniform_real_distribution<float> opening(0.1f, 1.0f);
+    std::uniform_int_distribution<uint32_t> pick(0, meters - 1);
+    for (uint32_t i = 0; i < meters; ++i) driven.setOpening(i, rng() % 2 ? opening(rng) : 0.0f);
+
+    const uint64_t ticks = static_cast<uint64_t>(hours * 3600.0 / FLEET_TICK_SECONDS);
+    const uint64_t ticksPerMinute = static_cast<uint64_t>(60.0f / FLEET_TICK_SECONDS);
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t t = 0; t < ticks; ++t) {
+        double seconds = t * static_cast<double>(FLEET_TICK_SECONDS);
+        driven.setSupplyPressureAll(static_cast<float>(300000.0 * (1.0 + 0.1 * std::sin(2.0 * M_PI * seconds / 86400.0))));
+        if (t % ticksPerMinute == 0) {
+            for (uint32_t k = 0; k < meters / 100 + 1; ++k) driven.setOpening(pick(rng), rng() % 2 ? opening(rng) : 0.0f);
+        }
+        driven.tick();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int64_t liters = 0;
+    for (uint32_t i = 0; i < fleet.size(); ++i) liters += fleet.getSnapshot(i).counter;
+    const PressureFlowSolver& solver = driven.getSolver();
+    const double meterTicks = static_cast<double>(ticks) * meters;
+    Logger::log(LogLevel::STARTUP, "[INFO] Pressão: " + std::to_string(meters) + " hidrômetros, " + std::to_string(hours) +
+                " h virtuais em " + std::to_string(elapsed) + " s (" +
+                std::to_string(static_cast<uint64_t>(meterTicks / elapsed)) + " meter-ticks/s)");
+    Logger::log(LogLevel::STARTUP, "[INFO] Solver: " + std::to_string(solver.getSolveCount()) + " soluções (" +
+                std::to_string(solver.getSolveCount() / std::max(1.0, meterTicks)) + " por meter-tick), " +
+                std::to_string(solver.getSolveCount() ? static_cast<double>(solver.getIterationCount()) / solver.getSolveCount() : 0.0) +
+                " iterações/solução, " + std::to_string(driven.getRejectedCount()) + " vazões recusadas");
+    Logger::log(LogLevel::STARTUP, "[INFO] Consumo: " + std::to_string(liters) + " L");
+    return 0;
+}
+
+// Modo coleta: frota dirigida pelos comportamentos em uma thread (1 min
+// virtual por snapshot) e ciclos de coleta contra o head-end local
+int runCollection(uint32_t meters, CollectionConfig config, const SweepConfig& shared) {
+    Logger::setDebugMode(true);
+    StandardFleet fleet;
+    fleet.reserve(meters);
+    for (uint32_t i = 0; i < meters; ++i) {
+        fleet.add(i % StandardFleet::MODEL_COUNT, 0, false);
+    }
+
+    FleetBehaviorTarget target(fleet);
+    BehaviorSchedulerConfig behaviorConfig;
+    behaviorConfig.threads = 1;
+    behaviorConfig.seed = shared.seed;
+    BehaviorScheduler scheduler(target, behaviorConfig);
+    for (uint32_t i = 0; i < meters; ++i) {
+        scheduler.spawn(i, tapCycle, TapCycleConfig());
+    }
+
+    SnapshotPublisher publisher;
+    publisher.publish(fleet, 0);
+    StopSignal driverStop;
+    std::thread driver([&]() {
+        do {
+            scheduler.run(std::chrono::minutes(1));
+            publisher.publish(fleet, static_cast<uint64_t>(scheduler.now().count()));
+        } while (driverStop.waitFor(std::chrono::milliseconds(100)) == StopSignal::Wake::TIMEOUT);
+    });
+
+    HeadEndServer headEnd;
+    bool ok = headEnd.start(config.socketPath);
+    if (shared.threads) config.threads = shared.threads;
+    config.seed = shared.seed;
+    CollectionEmulator emulator(config, publisher);
+    ok = ok && emulator.run();
+    driverStop.requestStop();
+    driver.join();
+    headEnd.stop();
+
+    const CollectionStats& stats = emulator.getStats();
+    HeadEndStats received = headEnd.getStats();
+    Logger::log(LogLevel::STARTUP, "[INFO] Coleta: " + std::to_string(stats.routeCycles) + " ciclos de rota, " +
+                std::to_string(stats.readings) + " leituras em " + std::to_string(stats.seconds) + " s (" +
+                std::to_string(static_cast<uint64_t>(stats.readingsPerSecond)) + " leituras/s)");
+    Logger::log(LogLevel::STARTUP, "[INFO] Latência do ciclo: p50 " + std::to_string(stats.latencyP50Ms) + " ms, p99 " +
+                std::to_string(stats.latencyP99Ms) + " ms, máx " + std::to_string(stats.latencyMaxMs) +
+                " ms (atraso de início máx " + std::to_string(stats.startLagMaxMs) + " ms)");
+    Logger::log(LogLevel::STARTUP, "[INFO] Novas tentativas: " + std::to_string(stats.retries) + ", sem resposta: " +
+                std::to_string(stats.missing) + ", lotes: " + std::to_string(stats.batches) + " (" +
+                std::to_string(stats.readings ? static_cast<double>(stats.bytes) / stats.readings : 0.0) + " bytes/leitura)");
+    bool consistent = received.readings == stats.readings && received.checksum == stats.checksum && received.malformed == 0;
+    Logger::log(LogLevel::STARTUP, std::string(consistent ? "[INFO]" : "[ERROR]") + " Head-end: " +
+                std::to_string(received.readings) + " leituras, " + std::to_string(received.batches) + " lotes, " +
+                (consistent ? "soma de verificação confere" : "divergência nas leituras recebidas"));
+    return ok && consistent ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    std::string shmName;
+    std::string imageSocket;
+    ThreadAffinity affinity;
+    bool sweepMode = false;
+    SweepConfig sweepConfig;
+    std::string sweepOut;
+    std::string fleetPath;
+    bool equivMode = false;
+    uint32_t behaviorMeters = 0;
+    double behaviorDays = 1.0;
+    float flowTau = 0.0f;
+    uint32_t pressureMeters = 0;
+    double pressureHours = 1.0;
+    uint32_t collectMeters = 0;
+    CollectionConfig collectConfig;
+    EquivalenceConfig equivConfig;
+    std::string equivEngine = "fleet";
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--shm")) {
+            shmName = (hasValue && argv[i + 1][0] == '/') ? argv[++i] : SHARED_FLEET_DEFAULT_NAME;
+        } else if (!strcmp(argv[i], "--image-socket")) {
+            imageSocket = (hasValue && argv[i + 1][0] != '-') ? argv[++i] : IMAGE_SERVICE_DEFAULT_PATH;
+        } else if (!strcmp(argv[i], "--sweep") && hasValue) {
+            sweepMode = true;
+            sweepConfig.scenarios = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--sweep-seconds") && hasValue) {
+            sweepConfig.virtualSeconds = std::stod(argv[++i]);
+        } else if (!strcmp(argv[i], "--threads") && hasValue) {
+            sweepConfig.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--seed") && hasValue) {
+            sweepConfig.seed = std::stoull(argv[++i]);
+        } else if (!strcmp(argv[i], "--sweep-out") && hasValue) {
+            sweepOut = argv[++i];
+        } else if (!strcmp(argv[i], "--pin-tick") && hasValue && parseCpuList(argv[i + 1], affinity.tick)) {
+            ++i;
+        } else if (!strcmp(argv[i], "--pin-render") && hasValue && parseCpuList(argv[i + 1], affinity.render)) {
+            ++i;
+        } else if (!strcmp(argv[i], "--pin-input") && hasValue && parseCpuList(argv[i + 1], affinity.input)) {
+            ++i;
+        } else if (!strcmp(argv[i], "--equiv") && hasValue) {
+            equivMode = true;
+            equivConfig.meters = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--equiv-ticks") && hasValue) {
+            equivConfig.ticks = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--equiv-every") && hasValue) {
+            equivConfig.compareEvery = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--equiv-engine") && hasValue) {
+            equivEngine = argv[++i];
+        } else if (!strcmp(argv[i], "--behaviors") && hasValue) {
+            behaviorMeters = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--behavior-days") && hasValue) {
+            behaviorDays = std::stod(argv[++i]);
+        } else if (!strcmp(argv[i], "--flow-tau") && hasValue) {
+            flowTau = std::stof(argv[++i]);
+        } else if (!strcmp(argv[i], "--pressure") && hasValue) {
+            pressureMeters = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--pressure-hours") && hasValue) {
+            pressureHours = std::stod(argv[++i]);
+        } else if (!strcmp(argv[i], "--collect") && hasValue) {
+            collectMeters = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--routes") && hasValue) {
+            collectConfig.routes = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--collect-cycles") && hasValue) {
+            collectConfig.cycles = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--collect-period") && hasValue) {
+            collectConfig.cyclePeriodMs = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (!strcmp(argv[i], "--fleet") && hasValue) {
+            fleetPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (sweepMode) {
+        return runSweep(sweepConfig, sweepOut);
+    }
+    if (equivMode) {
+        return runEquivalence(equivConfig, equivEngine, sweepConfig);
+    }
+    if (behaviorMeters > 0) {
+        return runBehaviors(behaviorMeters, behaviorDays, flowTau, sweepConfig);
+    }
+    if (pressureMeters > 0) {
+        return runPressure(pressureMeters, pressureHours, sweepConfig);
+    }
+    if (collectMeters > 0) {
+        return runCollection(collectMeters, collectConfig, sweepConfig);
+    }
+    if (!fleetPath.empty()) {
+        return runFleetLoad(fleetPath, sweepConfig.threads);
+    }
+
+    // Configura Ctrl+C (signalfd)
+    int interruptFd = blockInterruptSignal();
+    if (interruptFd < 0) {
+        std::cerr << "[ERROR] Não foi possível configurar o tratamento de Ctrl+C: " << strerror(errno) << std::endl;
+    }
     
     // Ativa modo debug apenas no início
     Logger::setDebugMode(true);
@@ -40,7 +430,14 @@ int main() {
     Logger::log(LogLevel::STARTUP, "[INFO] Criando instância do simulador...");
     
     Simulator simulator;
-    globalSimulator = &simulator; // Define ponteiro global para o handler
+    simulator.setAffinity(affinity);
+
+    if (!shmName.empty() && !simulator.enableSharedState(shmName)) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] Falha ao criar memória compartilhada - continuando sem publicação");
+    }
+    if (!imageSocket.empty() && !simulator.enableImageService(imageSocket)) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] Falha ao iniciar o serviço de imagens - continuando sem ele");
+    }
     
     Logger::log(LogLevel::STARTUP, "[INFO] Iniciando simulação...");
     simulator.run();
@@ -62,10 +459,8 @@ int main() {
     Logger::setRuntimeMode(true);
     Logger::clearRuntimeArea();
     
-    // Loop de monitoramento - verifica se o simulador ainda está rodando
-    while (simulator.isRunning()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    // Aguarda o fim da simulação (ESC) ou Ctrl+C
+    waitForShutdown(simulator, interruptFd);
     
     // Volta para modo de finalização
     Logger::setRuntimeMode(false);
@@ -74,8 +469,10 @@ int main() {
     Logger::log(LogLevel::SHUTDOWN, "");
     Logger::log(LogLevel::SHUTDOWN, "[INFO] Finalizando simulação...");
     simulator.stop();
+    logTickReport(simulator.getTickHistogram());
     Logger::log(LogLevel::SHUTDOWN, "[INFO] Simulação finalizada com sucesso!");
     Logger::log(LogLevel::SHUTDOWN, "========================================");
 
+    if (interruptFd >= 0) close(interruptFd);
     return 0;
 }
\ No newline at end of file
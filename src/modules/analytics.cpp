@@ -0,0 +1,163 @@
+#include "analytics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+FleetAnalytics::FleetAnalytics(size_t meterCount, const AnalyticsConfig& config)
+    : meterCount(meterCount),
+      config(config),
+      inNight(false),
+      primed(false),
+      meanFlow(meterCount, 0.0f),
+      varFlow(meterCount, 0.0f),
+      lossRatio(meterCount, 0.0f),
+      nightMin(meterCount, std::numeric_limits<float>::infinity()),
+      lastNightMin(meterCount, 0.0f),
+      uncountedLiters(meterCount, 0.0f),
+      lastCounter(meterCount, 0),
+      flags(meterCount, 0),
+      previousFlags(meterCount, 0) {}
+
+namespace {
+
+// Parâmetros escalares do kernel, iguais para toda a frota no tick
+struct KernelParams {
+    float aFlow;
+    float aLoss;
+    float nightMask;
+    float minFlow;
+    float leakLoss;
+    float leakNight;
+    float burstK2;
+    float burstMin;
+    float stuckLiters;
+    float litersPerTick;
+};
+
+const uint32_t LEAK_FLAG = static_cast<uint32_t>(AlertType::LEAK);
+const uint32_t BURST_FLAG = static_cast<uint32_t>(AlertType::BURST);
+const uint32_t STUCK_FLAG = static_cast<uint32_t>(AlertType::STUCK);
+
+// Kernel principal: sem desvios por elemento (apenas selects) e ponteiros
+// restrict, para que o compilador vetorize o laço inteiro
+void analyticsKernel(size_t n, const KernelParams p,
+                     const float* __restrict flowIN, const float* __restrict flowOUT,
+                     const int32_t* __restrict counter,
+                     float* __restrict mean, float* __restrict var, float* __restrict loss,
+                     float* __restrict nmin, const float* __restrict lastNmin,
+                     float* __restrict uncounted, int32_t* __restrict lastCtr,
+                     uint32_t* __restrict flags) {
+    const float inf = std::numeric_limits<float>::infinity();
+
+    for (size_t i = 0; i < n; ++i) {
+        const float in = flowIN[i];
+        const float out = flowOUT[i];
+
+        // Pico: compara com média/variância anteriores ao tick
+        const float dev = in - mean[i];
+        const uint32_t burst = (dev > p.burstMin ? BURST_FLAG : 0u) &
+                               (dev * dev > p.burstK2 * var[i] ? BURST_FLAG : 0u);
+
+        // EWMA de média e variância da vazão
+        mean[i] += p.aFlow * dev;
+        var[i] = (1.0f - p.aFlow) * (var[i] + p.aFlow * dev * dev);
+
+        // Razão de perda IN/OUT, atualizada apenas com vazão presente
+        const float ratio = (in - out) / std::max(in, p.minFlow);
+        const float weight = in > p.minFlow ? p.aLoss : 0.0f;
+        loss[i] += weight * (ratio - loss[i]);
+
+        // Vazão mínima da janela noturna
+        const float candidate = p.nightMask > 0.0f ? in : inf;
+        nmin[i] = std::min(nmin[i], candidate);
+
+        // Litros esperados (pela vazão OUT) desde o último avanço do contador
+        const int32_t c = counter[i];
+        const float keep = c != lastCtr[i] ? 0.0f : 1.0f;
+        uncounted[i] = (uncounted[i] + out * p.litersPerTick) * keep;
+        lastCtr[i] = c;
+
+        const uint32_t leak = (loss[i] > p.leakLoss ? LEAK_FLAG : 0u) |
+                              (lastNmin[i] > p.leakNight ? LEAK_FLAG : 0u);
+        const uint32_t stuck = uncounted[i] > p.stuckLiters ? STUCK_FLAG : 0u;
+        flags[i] = leak | burst | stuck;
+    }
+}
+
+} // namespace
+
+void FleetAnalytics::tick(const float* flowIN, const float* flowOUT, const int32_t* counter,
+                          float dt, float secondsOfDay, std::vector<AnalyticsAlert>& alerts) {
+    const size_t n = this->meterCount;
+
+    // Primeiro tick apenas inicializa as referências de contador
+    if (!this->primed) {
+        std::copy(counter, counter + n, this->lastCounter.begin());
+        this->primed = true;
+    }
+
+    // Decisões comuns a toda a frota ficam fora do kernel
+    const bool night = secondsOfDay >= this->config.nightStart && secondsOfDay < this->config.nightEnd;
+    const bool nightEnded = this->inNight && !night;
+    this->inNight = night;
+
+    KernelParams p;
+    p.aFlow = 1.0f - std::exp2(-dt / this->config.flowHalfLife);
+    p.aLoss = 1.0f - std::exp2(-dt / this->config.lossHalfLife);
+    p.nightMask = night ? 1.0f : 0.0f;
+    p.minFlow = this->config.minFlow;
+    p.leakLoss = this->config.leakLossRatio;
+    p.leakNight = this->config.leakNightFlow;
+    p.burstK2 = this->config.burstSigma * this->config.burstSigma;
+    p.burstMin = this->config.burstMinFlow;
+    p.stuckLiters = this->config.stuckLiters;
+    p.litersPerTick = dt * 1000.0f;
+
+    if (nightEnded) {
+        // Fecha a janela noturna: guarda o mínimo e reinicia o acumulador
+        const float inf = std::numeric_limits<float>::infinity();
+        for (size_t i = 0; i < n; ++i) {
+            this->lastNightMin[i] = this->nightMin[i] == inf ? 0.0f : this->nightMin[i];
+            this->nightMin[i] = inf;
+        }
+    }
+
+    analyticsKernel(n, p, flowIN, flowOUT, counter,
+                    this->meanFlow.data(), this->varFlow.data(), this->lossRatio.data(),
+                    this->nightMin.data(), this->lastNightMin.data(),
+                    this->uncountedLiters.data(), this->lastCounter.data(), this->flags.data());
+
+    // Emissão de alertas na borda de subida (flags novas em relação ao tick anterior)
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t raised = this->flags[i] & ~this->previousFlags[i];
+        this->previousFlags[i] = this->flags[i];
+        if (raised == 0) continue;
+
+        if (raised & LEAK_FLAG) {
+            float value = this->lossRatio[i] > p.leakLoss ? this->lossRatio[i] : this->lastNightMin[i];
+            alerts.push_back({static_cast<uint32_t>(i), AlertType::LEAK, value});
+        }
+        if (raised & BURST_FLAG) {
+            alerts.push_back({static_cast<uint32_t>(i), AlertType::BURST, flowIN[i]});
+        }
+        if (raised & STUCK_FLAG) {
+            alerts.push_back({static_cast<uint32_t>(i), AlertType::STUCK, this->uncountedLiters[i]});
+        }
+    }
+}
+
+size_t FleetAnalytics::size() const { return this->meterCount; }
+float FleetAnalytics::getMeanFlow(size_t meter) const { return this->meanFlow[meter]; }
+float FleetAnalytics::getFlowStdDev(size_t meter) const { return std::sqrt(this->varFlow[meter]); }
+float FleetAnalytics::getLossRatio(size_t meter) const { return this->lossRatio[meter]; }
+float FleetAnalytics::getNightMinFlow(size_t meter) const { return this->lastNightMin[meter]; }
+uint32_t FleetAnalytics::getFlags(size_t meter) const { return this->flags[meter]; }
+
+std::string FleetAnalytics::alertName(AlertType type) {
+    switch (type) {
+        case AlertType::LEAK:  return "VAZAMENTO";
+        case AlertType::BURST: return "PICO";
+        case AlertType::STUCK: return "TRAVADO";
+    }
+    return "DESCONHECIDO";
+}
@@ -0,0 +1,77 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Detecção online de vazamentos e anomalias sobre as vazões da frota.
+//
+// O estado de cada hidrômetro fica em arrays SoA (um vetor por estatística)
+// e é atualizado por um kernel sem desvios por elemento, que o compilador
+// vetoriza. Alertas são emitidos apenas na borda de subida de cada flag.
+
+enum class AlertType : uint32_t {
+    LEAK  = 1u << 0,   // perda IN/OUT acima do esperado ou vazão mínima noturna alta
+    BURST = 1u << 1,   // pico de vazão muito acima da média móvel
+    STUCK = 1u << 2    // vazão registrada sem avanço do contador
+};
+
+struct AnalyticsAlert {
+    uint32_t meter;
+    AlertType type;
+    float value;       // razão de perda, vazão (m³/s) ou litros não contabilizados
+};
+
+struct AnalyticsConfig {
+    float flowHalfLife = 60.0f;        // meia-vida da EWMA de vazão (s)
+    float lossHalfLife = 300.0f;       // meia-vida da EWMA da razão de perda (s)
+    float minFlow = 1e-6f;             // vazão abaixo disso é tratada como zero (m³/s)
+    float leakLossRatio = 0.15f;       // perda esperada é 10%; acima disso indica vazamento
+    float leakNightFlow = 2e-5f;       // vazão mínima noturna acima disso indica vazamento (m³/s)
+    float burstSigma = 4.0f;           // desvios-padrão acima da média para pico
+    float burstMinFlow = 2e-3f;        // salto mínimo acima da média para pico (m³/s)
+    float stuckLiters = 5.0f;          // litros esperados sem avanço do contador
+    float nightStart = 2.0f * 3600.0f; // janela noturna (segundos do dia)
+    float nightEnd = 4.0f * 3600.0f;
+};
+
+class FleetAnalytics {
+public:
+    explicit FleetAnalytics(size_t meterCount, const AnalyticsConfig& config = AnalyticsConfig());
+
+    // Processa um tick de dt segundos para todos os hidrômetros.
+    // flowIN/flowOUT em m³/s, counter em litros; secondsOfDay define a janela noturna.
+    // Alertas novos são anexados a alerts.
+    void tick(const float* flowIN, const float* flowOUT, const int32_t* counter,
+              float dt, float secondsOfDay, std::vector<AnalyticsAlert>& alerts);
+
+    size_t size() const;
+    float getMeanFlow(size_t meter) const;
+    float getFlowStdDev(size_t meter) const;
+    float getLossRatio(size_t meter) const;
+    float getNightMinFlow(size_t meter) const;   // última janela noturna concluída
+    uint32_t getFlags(size_t meter) const;
+
+    static std::string alertName(AlertType type);
+
+private:
+    size_t meterCount;
+    AnalyticsConfig config;
+    bool inNight;
+    bool primed;
+
+    // Estado SoA por hidrômetro
+    std::vector<float> meanFlow;
+    std::vector<float> varFlow;
+    std::vector<float> lossRatio;
+    std::vector<float> nightMin;
+    std::vector<float> lastNightMin;
+    std::vector<float> uncountedLiters;
+    std::vector<int32_t> lastCounter;
+    std::vector<uint32_t> flags;
+    std::vector<uint32_t> previousFlags;
+};
+
+#endif // ANALYTICS_H
@@ -0,0 +1,490 @@
+#include "behavior.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const uint64_t GOLDEN = 0x9E3779B97F4A7C15ull;
+const size_t RESUME_CHUNK = 1024;     // vencidos retomados por tarefa do pool
+const unsigned DEFAULT_MAX_THREADS = 4;
+
+std::atomic<size_t> frameBytes(0);
+
+uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------- alvo
+
+FleetBehaviorTarget::FleetBehaviorTarget(StandardFleet& fleet) : fleet(fleet), synced(fleet.size(), 0) {}
+
+float FleetBehaviorTarget::getMaxFlow(uint32_t meter) const { return this->fleet.getMaxFlow(meter); }
+
+void FleetBehaviorTarget::enableFlowDynamics(const FlowDynamicsConfig& config) {
+    this->dynamics = std::make_unique<FlowDynamics>(this->fleet.size(), config);
+    this->inRamp.assign(this->fleet.size(), 0);
+    for (uint32_t meter = 0; meter < this->fleet.size(); ++meter) {
+        this->dynamics->setFlow(meter, this->fleet.getSnapshot(meter).flowIN, this->seconds());
+    }
+}
+
+const FlowDynamics* FleetBehaviorTarget::getFlowDynamics() const { return this->dynamics.get(); }
+
+void FleetBehaviorTarget::setFlowRate(uint32_t meter, float flow) {
+    this->catchUp(meter);
+    if (!this->dynamics) {
+        this->fleet.setFlowRate(meter, flow);
+        return;
+    }
+
+    // Mesma recusa de Pipe::setFlowRate antes de virar alvo; a rampa fica
+    // entre a vazão atual e o alvo, sempre aceita pela frota
+    float maxFlow = this->fleet.getMaxFlow(meter);
+    if (flow < 0.0f || flow > maxFlow * (1.0f + FLEET_FLOW_TOLERANCE)) return;
+    const double t = this->seconds();
+    // Em regime a frota já contou o volume até aqui
+    if (!this->inRamp[meter]) this->dynamics->takeLiters(meter, t);
+    this->dynamics->setTarget(meter, std::min(flow, maxFlow), t);
+    this->fleet.setFlowRate(meter, this->dynamics->getFlow(meter));
+    this->inRamp[meter] = this->dynamics->isSteady(meter) ? 0 : 1;
+}
+
+void FleetBehaviorTarget::activate(uint32_t meter) {
+    this->catchUp(meter);
+    this->fleet.activate(meter);
+}
+
+void FleetBehaviorTarget::deactivate(uint32_t meter) {
+    this->catchUp(meter);
+    this->fleet.deactivate(meter);
+}
+
+// Nada é integrado aqui: cada hidrômetro é posto em dia na próxima manobra
+// ou em sync(), inclusive os que estão em rampa
+void FleetBehaviorTarget::advance(uint64_t ticks) { this->now += static_cast<uint32_t>(ticks); }
+
+void FleetBehaviorTarget::sync() {
+    for (uint32_t meter = 0; meter < this->synced.size(); ++meter) this->catchUp(meter);
+}
+
+MeterSnapshot FleetBehaviorTarget::getSnapshot(uint32_t meter) const {
+    if (!this->dynamics || !this->inRamp[meter]) {
+        return this->fleet.getSnapshot(meter, this->now - this->synced[meter]);
+    }
+    // Em rampa: vazão e volume de FlowDynamics até agora, sem integrá-lo
+    const double t = this->seconds();
+    MeterSnapshot snap = this->fleet.getSnapshot(meter);
+    snap.flowIN = this->dynamics->getFlow(meter, t);
+    snap.flowOUT = snap.status ? snap.flowIN * FLEET_LOSS_FACTOR : 0.0f;
+    if (snap.status) {
+        snap.counter = static_cast<int32_t>(this->fleet.getLiters(meter) +
+                                            static_cast<float>(this->dynamics->getLiters(meter, t)));
+    }
+    return snap;
+}
+
+// Vazões constantes desde a última manobra: o intervalo é integrado de uma
+// vez, com o mesmo resultado das somas tick a tick (Fleet::advance). Em rampa
+// o volume vem de FlowDynamics (passo adaptativo e trapézio) e a frota fica
+// com a vazão de agora; acomodado, o hidrômetro volta ao caso constante.
+void FleetBehaviorTarget::catchUp(uint32_t meter) {
+    uint32_t elapsed = this->now - this->synced[meter];
+    if (elapsed == 0) return;
+    if (this->dynamics && this->inRamp[meter]) {
+        const double t = this->seconds();
+        float liters = static_cast<float>(this->dynamics->takeLiters(meter, t));
+        if (this->fleet.getSnapshot(meter).status) this->fleet.addLiters(meter, liters);
+        this->fleet.setFlowRate(meter, this->dynamics->getFlow(meter));
+        if (this->dynamics->isSteady(meter)) this->inRamp[meter] = 0;
+    } else {
+        this->fleet.advance(meter, elapsed);
+    }
+    this->synced[meter] = this->now;
+}
+
+double FleetBehaviorTarget::seconds() const { return this->now * static_cast<double>(FLEET_TICK_SECONDS); }
+
+// ---------------------------------------------------------------- Behavior
+
+Behavior Behavior::promise_type::get_return_object() noexcept {
+    return Behavior(Handle::from_promise(*this));
+}
+
+void Behavior::promise_type::unhandled_exception() const noexcept {
+    Logger::log(LogLevel::STARTUP, "[ERROR] Behavior - Exceção não tratada; comportamento encerrado");
+}
+
+void* Behavior::promise_type::operator new(std::size_t bytes) {
+    frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+    return ::operator new(bytes);
+}
+
+void Behavior::promise_type::operator delete(void* frame, std::size_t bytes) noexcept {
+    frameBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    ::operator delete(frame);
+}
+
+Behavior::Behavior(Handle handle) noexcept : handle(handle) {}
+
+Behavior::Behavior(Behavior&& other) noexcept : handle(other.release()) {}
+
+Behavior& Behavior::operator=(Behavior&& other) noexcept {
+    if (this != &other) {
+        if (this->handle) this->handle.destroy();
+        this->handle = other.release();
+    }
+    return *this;
+}
+
+Behavior::~Behavior() {
+    if (this->handle) this->handle.destroy();
+}
+
+Behavior::Handle Behavior::release() noexcept { return std::exchange(this->handle, nullptr); }
+
+size_t Behavior::liveFrameBytes() { return frameBytes.load(std::memory_order_relaxed); }
+
+// ---------------------------------------------------------------- BehaviorMeter
+
+bool BehaviorSleep::await_ready() const noexcept { return this->when <= this->scheduler->time; }
+
+void BehaviorSleep::await_suspend(std::coroutine_handle<> handle) const {
+    this->scheduler->pushTimer(this->when, handle);
+}
+
+BehaviorMeter::BehaviorMeter(BehaviorScheduler* scheduler, uint32_t id, uint64_t seed)
+    : scheduler(scheduler), meter(id), state(seed) {}
+
+uint32_t BehaviorMeter::id() const { return this->meter; }
+BehaviorTicks BehaviorMeter::now() const { return BehaviorTicks(this->scheduler->time); }
+float BehaviorMeter::maxFlow() const { return this->scheduler->target.getMaxFlow(this->meter); }
+
+void BehaviorMeter::setFlowRate(float flow) {
+    this->scheduler->push({this->meter, BehaviorScheduler::CommandType::SET_FLOW, flow});
+}
+
+void BehaviorMeter::activate() {
+    this->scheduler->push({this->meter, BehaviorScheduler::CommandType::ACTIVATE, 0.0f});
+}
+
+void BehaviorMeter::deactivate() {
+    this->scheduler->push({this->meter, BehaviorScheduler::CommandType::DEACTIVATE, 0.0f});
+}
+
+BehaviorSleep BehaviorMeter::sleep(BehaviorTicks duration) const {
+    return BehaviorSleep{this->scheduler, this->scheduler->time + std::max<int64_t>(0, duration.count())};
+}
+
+BehaviorSleep BehaviorMeter::sleepUntil(BehaviorTicks time) const {
+    return BehaviorSleep{this->scheduler, time.count()};
+}
+
+double BehaviorMeter::uniform() {
+    this->state += GOLDEN;
+    return static_cast<double>(mix(this->state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+BehaviorTicks BehaviorMeter::exponential(BehaviorTicks mean) {
+    double ticks = -std::log1p(-this->uniform()) * static_cast<double>(mean.count());
+    return BehaviorTicks(1 + static_cast<int64_t>(std::min(ticks, 1.0e15)));
+}
+
+Behavior tapCycle(BehaviorMeter meter, TapCycleConfig config) {
+    const float maxFlow = meter.maxFlow();
+    const float leak = config.leakFraction * maxFlow;
+    auto base = [&]() { return meter.now() >= config.leakAfter ? leak : 0.0f; };
+
+    meter.activate();
+    // Fase inicial aleatória para a frota não abrir as torneiras em sincronia
+    co_await meter.sleep(meter.exponential(config.meanIdle));
+    for (;;) {
+        meter.setFlowRate(config.openFraction * maxFlow + base());
+        co_await meter.sleep(config.openTime);
+        meter.setFlowRate(base());
+
+        BehaviorTicks end = meter.now() + meter.exponential(config.meanIdle);
+        if (meter.now() < config.leakAfter && end > config.leakAfter) {
+            co_await meter.sleepUntil(config.leakAfter);
+            meter.setFlowRate(leak);
+        }
+        co_await meter.sleepUntil(end);
+    }
+}
+
+// ---------------------------------------------------------------- roda de temporizadores
+
+void BehaviorScheduler::TimerWheel::schedule(const TimerEntry& entry) {
+    ++this->count;
+    this->place(entry);
+}
+
+// Nível mais baixo cuja janela contém o prazo (prazos >= current)
+void BehaviorScheduler::TimerWheel::place(const TimerEntry& entry) {
+    int64_t when = std::max(entry.when, this->current);
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = SLOT_BITS * (level + 1);
+        if ((when >> shift) == (this->current >> shift)) {
+            this->slots[level][(when >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back({when, entry.handle});
+            return;
+        }
+    }
+    this->overflow.push_back(entry);
+}
+
+void BehaviorScheduler::TimerWheel::collect(std::vector<TimerEntry>& due) {
+    const int64_t t = this->current;
+    // Ao entrar em uma nova janela, redistribui os níveis de cima para baixo
+    if (t != 0 && (t & ((int64_t(1) << (SLOT_BITS * LEVELS)) - 1)) == 0) {
+        std::vector<TimerEntry> pending;
+        pending.swap(this->overflow);
+        for (const TimerEntry& entry : pending) this->place(entry);
+    }
+    for (int level = LEVELS - 1; level >= 1; --level) {
+        if (t == 0 || (t & ((int64_t(1) << (SLOT_BITS * level)) - 1)) != 0) continue;
+        std::vector<TimerEntry>& slot = this->slots[level][(t >> (SLOT_BITS * level)) & (SLOTS - 1)];
+        if (slot.empty()) continue;
+        std::vector<TimerEntry> pending;
+        pending.swap(slot);
+        for (const TimerEntry& entry : pending) this->place(entry);
+    }
+
+    due.clear();
+    due.swap(this->slots[0][t & (SLOTS - 1)]);
+    this->count -= due.size();
+    ++this->current;
+}
+
+void BehaviorScheduler::TimerWheel::skipTo(int64_t time) {
+    if (this->count == 0 && time > this->current) this->current = time;
+}
+
+size_t BehaviorScheduler::TimerWheel::capacityBytes() const {
+    size_t entries = this->overflow.capacity();
+    for (const auto& level : this->slots) {
+        for (const auto& slot : level) entries += slot.capacity();
+    }
+    return entries * sizeof(TimerEntry);
+}
+
+void BehaviorScheduler::TimerWheel::destroyAll() {
+    for (auto& level : this->slots) {
+        for (auto& slot : level) {
+            for (const TimerEntry& entry : slot) entry.handle.destroy();
+            slot.clear();
+        }
+    }
+    for (const TimerEntry& entry : this->overflow) entry.handle.destroy();
+    this->overflow.clear();
+    this->count = 0;
+}
+
+// ---------------------------------------------------------------- pool
+
+// Threads fixas que dividem as tarefas de um tick; a thread chamadora
+// também trabalha e retorna quando todas as tarefas terminaram
+class BehaviorScheduler::Pool {
+public:
+    explicit Pool(unsigned threads) {
+        for (unsigned t = 1; t < threads; ++t) this->workers.emplace_back(&Pool::work, this);
+    }
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->wake.notify_all();
+        for (std::thread& worker : this->workers) worker.join();
+    }
+
+    void run(size_t tasks, const std::function<void(size_t)>& fn) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->job = &fn;
+            this->tasks = tasks;
+            this->next.store(0);
+            this->active = this->workers.size();
+            ++this->generation;
+        }
+        this->wake.notify_all();
+        this->claim(fn, tasks);
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->done.wait(lock, [this]() { return this->active == 0; });
+    }
+
+    unsigned size() const { return static_cast<unsigned>(this->workers.size() + 1); }
+
+private:
+    void claim(const std::function<void(size_t)>& fn, size_t tasks) {
+        for (size_t task = this->next.fetch_add(1); task < tasks; task = this->next.fetch_add(1)) fn(task);
+    }
+
+    void work() {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* fn;
+            size_t tasks;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->wake.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+                if (this->stopping) return;
+                seen = this->generation;
+                fn = this->job;
+                tasks = this->tasks;
+            }
+            this->claim(*fn, tasks);
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (--this->active == 0) this->done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)>* job = nullptr;
+    size_t tasks = 0;
+    std::atomic<size_t> next{0};
+    size_t active = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+};
+
+// ---------------------------------------------------------------- BehaviorScheduler
+
+thread_local BehaviorScheduler::Batch* BehaviorScheduler::currentBatch = nullptr;
+
+BehaviorScheduler::BehaviorScheduler(BehaviorTarget& target, const BehaviorSchedulerConfig& config)
+    : target(target),
+      config(config)
+{
+    unsigned threads = this->config.threads;
+    if (threads == 0) threads = std::min(DEFAULT_MAX_THREADS, std::max(1u, std::thread::hardware_concurrency()));
+    this->pool = std::make_unique<Pool>(threads);
+}
+
+BehaviorScheduler::~BehaviorScheduler() {
+    this->pool.reset();
+    this->wheel.destroyAll();
+}
+
+uint64_t BehaviorScheduler::nextSeed(uint32_t meter) {
+    return mix(mix(this->config.seed + GOLDEN * (static_cast<uint64_t>(meter) + 1)) ^ this->stats.spawned);
+}
+
+void BehaviorScheduler::adopt(Behavior behavior) {
+    Behavior::Handle handle = behavior.release();
+    if (!handle) return;
+    ++this->stats.spawned;
+    this->wheel.schedule({this->time, handle});
+}
+
+void BehaviorScheduler::push(const Command& command) { currentBatch->commands.push_back(command); }
+
+void BehaviorScheduler::pushTimer(int64_t when, std::coroutine_handle<> handle) {
+    currentBatch->timers.push_back({when, handle});
+}
+
+void BehaviorScheduler::resumeRange(Batch& batch, size_t first, size_t last) {
+    currentBatch = &batch;
+    for (size_t i = first; i < last; ++i) {
+        std::coroutine_handle<> handle = this->due[i].handle;
+        handle.resume();
+        ++batch.resumes;
+        // Um comportamento suspenso sempre registrou um prazo; os demais terminaram
+        if (handle.done()) {
+            handle.destroy();
+            ++batch.finished;
+        }
+    }
+    currentBatch = nullptr;
+}
+
+void BehaviorScheduler::advanceTarget(int64_t time) {
+    if (time > this->targetTime) {
+        this->target.advance(static_cast<uint64_t>(time - this->targetTime));
+        this->targetTime = time;
+    }
+}
+
+void BehaviorScheduler::step() {
+    this->time = this->wheel.getCurrent();
+    this->wheel.collect(this->due);
+    const size_t count = this->due.size();
+    if (count > 0) {
+        const size_t chunks = (count + RESUME_CHUNK - 1) / RESUME_CHUNK;
+        if (this->batches.size() < chunks) this->batches.resize(chunks);
+        for (size_t c = 0; c < chunks; ++c) {
+            Batch& batch = this->batches[c];
+            batch.commands.clear();
+            batch.timers.clear();
+            batch.resumes = 0;
+            batch.finished = 0;
+        }
+
+        if (chunks == 1 || this->pool->size() == 1) {
+            this->resumeRange(this->batches[0], 0, count);
+        } else {
+            std::function<void(size_t)> task = [this, count](size_t c) {
+                this->resumeRange(this->batches[c], c * RESUME_CHUNK, std::min(count, (c + 1) * RESUME_CHUNK));
+            };
+            this->pool->run(chunks, task);
+        }
+
+        // Aplicação na ordem da lista de vencidos (independe das threads)
+        for (size_t c = 0; c < chunks; ++c) {
+            Batch& batch = this->batches[c];
+            if (!batch.commands.empty()) this->advanceTarget(this->time);
+            for (const Command& command : batch.commands) {
+                switch (command.type) {
+                    case CommandType::SET_FLOW: this->target.setFlowRate(command.meter, command.flow); break;
+                    case CommandType::ACTIVATE: this->target.activate(command.meter); break;
+                    case CommandType::DEACTIVATE: this->target.deactivate(command.meter); break;
+                }
+            }
+            for (const TimerEntry& entry : batch.timers) this->wheel.schedule(entry);
+            this->stats.resumes += batch.resumes;
+            this->stats.finished += batch.finished;
+            this->stats.commands += batch.commands.size();
+        }
+    }
+    this->time = this->wheel.getCurrent();
+}
+
+void BehaviorScheduler::run(BehaviorTicks duration) {
+    auto start = std::chrono::steady_clock::now();
+    const int64_t end = this->time + std::max<int64_t>(0, duration.count());
+    while (this->time < end) {
+        if (this->wheel.size() == 0) {
+            this->wheel.skipTo(end);
+            this->time = end;
+            break;
+        }
+        this->step();
+    }
+    this->advanceTarget(end);
+    this->target.sync();
+    this->stats.virtualTicks = static_cast<uint64_t>(this->time);
+    this->stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+BehaviorTicks BehaviorScheduler::now() const { return BehaviorTicks(this->time); }
+
+BehaviorStats BehaviorScheduler::getStats() const {
+    BehaviorStats snapshot = this->stats;
+    snapshot.live = snapshot.spawned - snapshot.finished;
+    snapshot.frameBytes = Behavior::liveFrameBytes();
+    snapshot.timerBytes = this->wheel.capacityBytes();
+    return snapshot;
+}
@@ -0,0 +1,282 @@
+#ifndef BEHAVIOR_H
+#define BEHAVIOR_H
+
+#include "fleet.hpp"
+#include "flow_dynamics.hpp"
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Comportamentos de hidrômetros escritos como corrotinas C++20, por exemplo:
+//
+//     Behavior torneira(BehaviorMeter meter) {
+//         for (;;) {
+//             meter.setFlowRate(0.4f * meter.maxFlow());
+//             co_await meter.sleep(std::chrono::minutes(3));
+//             meter.setFlowRate(0.0f);
+//             co_await meter.sleep(meter.exponential(std::chrono::minutes(20)));
+//         }
+//     }
+//
+// O BehaviorScheduler avança o tempo virtual em ticks de 0.1 s com uma roda
+// de temporizadores hierárquica: um comportamento suspenso custa apenas o
+// quadro da corrotina e uma entrada de 16 bytes na roda, então milhões deles
+// cabem em memória sem uma thread por hidrômetro. A cada tick os
+// comportamentos vencidos são retomados em um pequeno pool de threads; as
+// manobras (setFlowRate, activate, deactivate) e os novos prazos são
+// aplicados depois, na ordem da lista de vencidos, de modo que o resultado
+// independe do número de threads.
+
+// Tempo virtual, na resolução do tick da frota
+using BehaviorTicks = std::chrono::duration<int64_t, std::deci>;
+static_assert(FLEET_TICK_SECONDS == 0.1f, "BehaviorTicks assume ticks de 0.1 s");
+
+// Hidrômetros controlados pelos comportamentos
+class BehaviorTarget {
+public:
+    virtual ~BehaviorTarget() = default;
+    virtual float getMaxFlow(uint32_t meter) const = 0;
+    virtual void setFlowRate(uint32_t meter, float flow) = 0;
+    virtual void activate(uint32_t meter) = 0;
+    virtual void deactivate(uint32_t meter) = 0;
+    virtual void advance(uint64_t ticks) = 0;   // o tempo avança ticks × 0.1 s
+    virtual void sync() {}                      // fim de run(): estado em dia com o tempo
+};
+
+// StandardFleet (mesmas regras de Pipe::setFlowRate e Hidrometer::update).
+// A vazão de um hidrômetro só muda nas suas manobras, então cada um é
+// integrado de uma vez desde a manobra anterior (Fleet::advance) em vez de
+// a frota inteira avançar a cada tick; sync() põe todos em dia. O contador
+// sai idêntico ao das somas tick a tick de Hidrometer::update, inclusive
+// quando o float já não absorve o incremento (ver fleet_detail::accumulate).
+//
+// Com enableFlowDynamics(), setFlowRate passa a definir a vazão-alvo de
+// FlowDynamics em vez de aplicar o degrau. Um hidrômetro em transitório
+// também só é posto em dia nas manobras e em sync(): FlowDynamics o integra
+// com passo adaptativo até lá e o volume é somado ao contador da frota; ao se
+// acomodar ele volta à integração por manobra.
+class FleetBehaviorTarget : public BehaviorTarget {
+public:
+    explicit FleetBehaviorTarget(StandardFleet& fleet);
+    void enableFlowDynamics(const FlowDynamicsConfig& config = FlowDynamicsConfig());
+    const FlowDynamics* getFlowDynamics() const;
+    float getMaxFlow(uint32_t meter) const override;
+    void setFlowRate(uint32_t meter, float flow) override;
+    void activate(uint32_t meter) override;
+    void deactivate(uint32_t meter) override;
+    void advance(uint64_t ticks) override;
+    void sync() override;
+
+    // Estado do hidrômetro no tempo atual, sem integrá-lo (a frota só fica
+    // em dia nas manobras e em sync())
+    MeterSnapshot getSnapshot(uint32_t meter) const;
+
+private:
+    void catchUp(uint32_t meter);
+    double seconds() const;   // tempo virtual em s
+
+    StandardFleet& fleet;
+    std::vector<uint32_t> synced;   // tick até onde cada hidrômetro foi integrado
+    uint32_t now = 0;
+    std::unique_ptr<FlowDynamics> dynamics;
+    std::vector<uint8_t> inRamp;    // em transitório: volume vem de FlowDynamics
+};
+
+// Tipo de retorno das corrotinas de comportamento. O quadro é criado
+// suspenso e passa a pertencer ao BehaviorScheduler em spawn().
+class Behavior {
+public:
+    struct promise_type {
+        Behavior get_return_object() noexcept;
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept;
+
+        // Contabiliza a memória dos quadros vivos
+        static void* operator new(std::size_t bytes);
+        static void operator delete(void* frame, std::size_t bytes) noexcept;
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Behavior(Behavior&& other) noexcept;
+    Behavior& operator=(Behavior&& other) noexcept;
+    Behavior(const Behavior&) = delete;
+    Behavior& operator=(const Behavior&) = delete;
+    ~Behavior();
+
+    Handle release() noexcept;
+    static size_t liveFrameBytes();
+
+private:
+    explicit Behavior(Handle handle) noexcept;
+    Handle handle;
+};
+
+class BehaviorScheduler;
+
+// Aguardável de sleep()/sleepUntil()
+struct BehaviorSleep {
+    BehaviorScheduler* scheduler;
+    int64_t when;
+
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<> handle) const;
+    void await_resume() const noexcept {}
+};
+
+// Hidrômetro visto de dentro de um comportamento (passado por valor; vive
+// no quadro da corrotina). Só deve ser usado pela própria corrotina.
+class BehaviorMeter {
+public:
+    BehaviorMeter(BehaviorScheduler* scheduler, uint32_t id, uint64_t seed);
+
+    uint32_t id() const;
+    BehaviorTicks now() const;
+    float maxFlow() const;
+
+    void setFlowRate(float flow);
+    void activate();
+    void deactivate();
+
+    BehaviorSleep sleep(BehaviorTicks duration) const;
+    BehaviorSleep sleepUntil(BehaviorTicks time) const;
+
+    double uniform();                                  // [0, 1)
+    BehaviorTicks exponential(BehaviorTicks mean);     // >= 1 tick
+
+private:
+    BehaviorScheduler* scheduler;
+    uint32_t meter;
+    uint64_t state;
+};
+
+// Torneira com vazamento: abre a openFraction de maxFlow por openTime,
+// espera exponencial(meanIdle) e repete; a partir de leakAfter soma um
+// vazamento contínuo de leakFraction de maxFlow
+struct TapCycleConfig {
+    float openFraction = 0.4f;
+    BehaviorTicks openTime = std::chrono::minutes(3);
+    BehaviorTicks meanIdle = std::chrono::minutes(20);
+    BehaviorTicks leakAfter = std::chrono::hours(24 * 12);
+    float leakFraction = 0.02f;
+};
+
+Behavior tapCycle(BehaviorMeter meter, TapCycleConfig config);
+
+struct BehaviorSchedulerConfig {
+    unsigned threads = 0;          // 0 = até 4 núcleos
+    uint64_t seed = 1;
+};
+
+struct BehaviorStats {
+    uint64_t spawned = 0;
+    uint64_t finished = 0;
+    uint64_t live = 0;
+    uint64_t resumes = 0;
+    uint64_t commands = 0;
+    uint64_t virtualTicks = 0;
+    size_t frameBytes = 0;         // quadros de corrotina vivos
+    size_t timerBytes = 0;         // entradas na roda de temporizadores
+    double seconds = 0.0;          // tempo real gasto em run()
+};
+
+class BehaviorScheduler {
+public:
+    BehaviorScheduler(BehaviorTarget& target, const BehaviorSchedulerConfig& config = BehaviorSchedulerConfig());
+    ~BehaviorScheduler();
+
+    BehaviorScheduler(const BehaviorScheduler&) = delete;
+    BehaviorScheduler& operator=(const BehaviorScheduler&) = delete;
+
+    // Cria o comportamento script(BehaviorMeter, args...) para o hidrômetro;
+    // ele começa no tick atual. Não deve ser chamado de dentro de run().
+    template <typename Script, typename... Args>
+    void spawn(uint32_t meter, Script&& script, Args&&... args) {
+        BehaviorMeter handle(this, meter, this->nextSeed(meter));
+        this->adopt(std::forward<Script>(script)(handle, std::forward<Args>(args)...));
+    }
+
+    // Avança o tempo virtual; o alvo é integrado até o novo instante
+    void run(BehaviorTicks duration);
+
+    BehaviorTicks now() const;
+    BehaviorStats getStats() const;
+
+private:
+    friend struct BehaviorSleep;
+    friend class BehaviorMeter;
+
+    struct TimerEntry {
+        int64_t when;
+        std::coroutine_handle<> handle;
+    };
+
+    enum class CommandType : uint8_t { SET_FLOW, ACTIVATE, DEACTIVATE };
+
+    struct Command {
+        uint32_t meter;
+        CommandType type;
+        float flow;
+    };
+
+    // Saída da retomada de um trecho da lista de vencidos
+    struct Batch {
+        std::vector<Command> commands;
+        std::vector<TimerEntry> timers;
+        uint64_t resumes = 0;
+        uint64_t finished = 0;
+    };
+
+    // Roda hierárquica: 4 níveis de 256 posições (2^32 ticks, ~13 anos)
+    class TimerWheel {
+    public:
+        static const int LEVELS = 4;
+        static const int SLOT_BITS = 8;
+        static const int SLOTS = 1 << SLOT_BITS;
+
+        void schedule(const TimerEntry& entry);
+        void collect(std::vector<TimerEntry>& due);   // vencidos em current; avança current
+        int64_t getCurrent() const { return this->current; }
+        void skipTo(int64_t time);                     // apenas com a roda vazia
+        size_t size() const { return this->count; }
+        size_t capacityBytes() const;
+        void destroyAll();
+
+    private:
+        void place(const TimerEntry& entry);
+        std::array<std::array<std::vector<TimerEntry>, SLOTS>, LEVELS> slots;
+        std::vector<TimerEntry> overflow;
+        int64_t current = 0;
+        size_t count = 0;
+    };
+
+    class Pool;
+
+    void adopt(Behavior behavior);
+    uint64_t nextSeed(uint32_t meter);
+    void resumeRange(Batch& batch, size_t first, size_t last);
+    void step();
+    void push(const Command& command);
+    void pushTimer(int64_t when, std::coroutine_handle<> handle);
+    void advanceTarget(int64_t time);
+
+    static thread_local Batch* currentBatch;
+
+    BehaviorTarget& target;
+    BehaviorSchedulerConfig config;
+    TimerWheel wheel;
+    std::vector<TimerEntry> due;
+    std::vector<Batch> batches;
+    std::unique_ptr<Pool> pool;
+    int64_t time = 0;          // tick em execução (ou o próximo, fora de step)
+    int64_t targetTime = 0;    // instante até onde o alvo foi integrado
+    BehaviorStats stats;
+};
+
+#endif // BEHAVIOR_H
@@ -0,0 +1,333 @@
+#include "collection.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const uint64_t GOLDEN = 0x9E3779B97F4A7C15ull;
+
+uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+double millis(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Conexão de uma thread de coleta: envia lotes e confere as confirmações,
+// com até window lotes em voo
+class HeadEndConnection {
+public:
+    explicit HeadEndConnection(uint32_t window) : window(std::max(1u, window)) {}
+
+    ~HeadEndConnection() {
+        if (this->fd >= 0) close(this->fd);
+    }
+
+    bool open(const std::string& path) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) return false;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+        this->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (this->fd < 0 || connect(this->fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            Logger::log(LogLevel::STARTUP, "[ERROR] CollectionEmulator - Não foi possível conectar ao head-end em " +
+                        path + ": " + strerror(errno));
+            return false;
+        }
+        return true;
+    }
+
+    bool send(const std::string& batch, uint32_t sequence, uint32_t count) {
+        if (this->inFlight.size() >= this->window && !this->readAck()) return false;
+        size_t sent = 0;
+        while (sent < batch.size()) {
+            ssize_t n = ::send(this->fd, batch.data() + sent, batch.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        this->inFlight.push_back({sequence, count});
+        return true;
+    }
+
+    // Espera as confirmações de todos os lotes enviados
+    bool drain() {
+        while (!this->inFlight.empty()) {
+            if (!this->readAck()) return false;
+        }
+        return true;
+    }
+
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;
+
+private:
+    struct Pending {
+        uint32_t sequence;
+        uint32_t count;
+    };
+
+    bool readAck() {
+        ReadingAck ack;
+        size_t received = 0;
+        while (received < sizeof(ack)) {
+            ssize_t n = recv(this->fd, reinterpret_cast<char*>(&ack) + received, sizeof(ack) - received, 0);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                return false;
+            }
+            received += static_cast<size_t>(n);
+        }
+        Pending pending = this->inFlight.front();
+        this->inFlight.pop_front();
+        if (ack.magic != READING_ACK_MAGIC || ack.sequence != pending.sequence) return false;
+        if (ack.status != 0 || ack.accepted != pending.count) ++this->rejected;
+        this->accepted += ack.accepted;
+        return true;
+    }
+
+    int fd = -1;
+    uint32_t window;
+    std::deque<Pending> inFlight;
+};
+
+} // namespace
+
+void SnapshotPublisher::publish(const StandardFleet& fleet, uint64_t tick) {
+    std::shared_ptr<ReadingSnapshot> next;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->spare && this->spare.use_count() == 1) next = std::move(this->spare);
+    }
+    if (!next) next = std::make_shared<ReadingSnapshot>();
+
+    const size_t meters = fleet.size();
+    next->counters.resize(meters);
+    next->active.resize(meters);
+    for (uint32_t i = 0; i < meters; ++i) {
+        MeterSnapshot snap = fleet.getSnapshot(i);
+        next->counters[i] = snap.counter;
+        next->active[i] = static_cast<uint8_t>(snap.status);
+    }
+    next->tick = tick;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    next->epoch = ++this->epoch;
+    this->spare = std::move(this->current);
+    this->current = std::move(next);
+}
+
+std::shared_ptr<const ReadingSnapshot> SnapshotPublisher::acquire() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->current;
+}
+
+CollectionEmulator::CollectionEmulator(const CollectionConfig& config, const SnapshotPublisher& publisher)
+    : config(config),
+      publisher(publisher)
+{
+    if (this->config.routes == 0) this->config.routes = 1;
+    if (this->config.batchSize == 0) this->config.batchSize = 1;
+    if (this->config.threads == 0) this->config.threads = 1;
+}
+
+bool CollectionEmulator::run() {
+    const CollectionConfig& cfg = this->config;
+    this->stats = CollectionStats();
+
+    std::shared_ptr<const ReadingSnapshot> first = this->publisher.acquire();
+    if (!first || first->counters.empty()) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] CollectionEmulator::run - Nenhum snapshot da frota publicado");
+        return false;
+    }
+    const uint32_t meters = static_cast<uint32_t>(first->counters.size());
+    first.reset();
+
+    struct RouteCycle {
+        uint32_t route;
+        uint32_t cycle;
+        Clock::time_point scheduled;
+        std::shared_ptr<const ReadingSnapshot> snapshot;
+    };
+
+    struct Task {
+        Clock::time_point due;
+        uint32_t index;                  // em cycles
+        uint32_t attempt;
+        std::vector<uint32_t> meters;    // vazio na primeira tentativa (rota inteira)
+    };
+    auto later = [](const Task& a, const Task& b) { return a.due > b.due || (a.due == b.due && a.index > b.index); };
+
+    // Agenda: rota r, ciclo k em início + k * período (+ r * período / rotas)
+    const Clock::time_point start = Clock::now();
+    const auto period = std::chrono::milliseconds(cfg.cyclePeriodMs);
+    std::vector<RouteCycle> cycles;
+    std::vector<Task> heap;
+    for (uint32_t k = 0; k < cfg.cycles; ++k) {
+        for (uint32_t r = 0; r < cfg.routes; ++r) {
+            Clock::time_point scheduled = start + k * period;
+            if (cfg.stagger) scheduled += period * r / cfg.routes;
+            heap.push_back(Task{scheduled, static_cast<uint32_t>(cycles.size()), 0, {}});
+            cycles.push_back(RouteCycle{r, k, scheduled, nullptr});
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t remaining = cycles.size();
+    bool failed = false;
+    std::vector<double> latencies;
+    CollectionStats totals;
+    Clock::time_point finish = start;
+
+    auto worker = [&]() {
+        HeadEndConnection connection(cfg.window);
+        bool connected = connection.open(cfg.socketPath);
+        ReadingBatchEncoder encoder;
+        uint32_t sequence = 0;
+        CollectionStats local;
+        std::vector<uint32_t> silent;
+
+        // Uma falha em qualquer trabalhador encerra a execução: a agenda é
+        // esvaziada e quem estava no meio de uma tarefa sai ao religar o mutex
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!connected) {
+            failed = true;
+            remaining = 0;
+            heap.clear();
+            changed.notify_all();
+        }
+        while (remaining > 0 && !failed) {
+            if (heap.empty()) {
+                changed.wait(lock);
+                continue;
+            }
+            const Clock::time_point due = heap.front().due;
+            if (Clock::now() < due) {
+                changed.wait_until(lock, due);
+                continue;
+            }
+            std::pop_heap(heap.begin(), heap.end(), later);
+            Task task = std::move(heap.back());
+            heap.pop_back();
+            RouteCycle& rc = cycles[task.index];
+            if (task.attempt == 0) {
+                rc.snapshot = this->publisher.acquire();
+                local.startLagMaxMs = std::max(local.startLagMaxMs, millis(Clock::now() - rc.scheduled));
+            }
+            lock.unlock();
+
+            // Leitura do snapshot do ciclo em lotes
+            const ReadingSnapshot& snapshot = *rc.snapshot;
+            const uint16_t flags = task.attempt > 0 ? READING_BATCH_RETRY : 0;
+            bool ok = true;
+            auto flushBatch = [&]() {
+                if (encoder.count() == 0) return;
+                const std::string& batch = encoder.finish();
+                ok = ok && connection.send(batch, encoder.getSequence(), encoder.count());
+                ++local.batches;
+                local.bytes += batch.size();
+                encoder.begin(++sequence, rc.route, rc.cycle, snapshot.epoch, flags);
+            };
+            auto poll = [&](uint32_t meter) {
+                uint64_t r = mix(cfg.seed ^ GOLDEN * (static_cast<uint64_t>(task.index) + 1) ^
+                                 (static_cast<uint64_t>(meter) << 8 | task.attempt));
+                if (static_cast<double>(r >> 11) * (1.0 / 9007199254740992.0) >= cfg.responseRate) {
+                    silent.push_back(meter);
+                    return;
+                }
+                int32_t counter = snapshot.counters[meter];
+                bool active = snapshot.active[meter] != 0;
+                encoder.add(meter, counter, active);
+                local.checksum += readingChecksum(meter, counter, active);
+                if (encoder.count() >= cfg.batchSize) flushBatch();
+            };
+
+            silent.clear();
+            encoder.begin(++sequence, rc.route, rc.cycle, snapshot.epoch, flags);
+            if (task.attempt == 0) {
+                uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(meters) * rc.route / cfg.routes);
+                uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(meters) * (rc.route + 1) / cfg.routes);
+                end = std::min<uint32_t>(end, static_cast<uint32_t>(snapshot.counters.size()));
+                for (uint32_t meter = begin; meter < end && ok; ++meter) poll(meter);
+            } else {
+                local.retries += task.meters.size();
+                for (size_t i = 0; i < task.meters.size() && ok; ++i) poll(task.meters[i]);
+            }
+            flushBatch();
+            ok = ok && connection.drain();
+            Clock::time_point now = Clock::now();
+
+            lock.lock();
+            if (failed) break;
+            if (!ok) {
+                Logger::log(LogLevel::STARTUP, "[ERROR] CollectionEmulator::run - Conexão com o head-end perdida");
+                failed = true;
+                remaining = 0;
+                heap.clear();
+                changed.notify_all();
+                break;
+            }
+            if (!silent.empty() && task.attempt < cfg.maxRetries) {
+                heap.push_back(Task{now + std::chrono::milliseconds(cfg.retryDelayMs), task.index, task.attempt + 1, silent});
+                std::push_heap(heap.begin(), heap.end(), later);
+                changed.notify_all();
+            } else {
+                local.missing += silent.size();
+                ++local.routeCycles;
+                latencies.push_back(millis(now - rc.scheduled));
+                finish = std::max(finish, now);
+                rc.snapshot.reset();
+                if (--remaining == 0) changed.notify_all();
+            }
+        }
+
+        totals.routeCycles += local.routeCycles;
+        totals.missing += local.missing;
+        totals.retries += local.retries;
+        totals.batches += local.batches;
+        totals.bytes += local.bytes;
+        totals.checksum += local.checksum;
+        totals.readings += connection.accepted;
+        totals.rejected += connection.rejected;
+        totals.startLagMaxMs = std::max(totals.startLagMaxMs, local.startLagMaxMs);
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < cfg.threads; ++t) threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads) t.join();
+
+    this->stats = totals;
+    this->stats.seconds = millis(finish - start) / 1000.0;
+    if (this->stats.seconds > 0.0) this->stats.readingsPerSecond = this->stats.readings / this->stats.seconds;
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](double q) { return latencies[static_cast<size_t>(q * (latencies.size() - 1))]; };
+        this->stats.latencyP50Ms = percentile(0.50);
+        this->stats.latencyP99Ms = percentile(0.99);
+        this->stats.latencyMaxMs = latencies.back();
+    }
+    return !failed && this->stats.rejected == 0;
+}
+
+const CollectionStats& CollectionEmulator::getStats() const { return this->stats; }
@@ -0,0 +1,100 @@
+#ifndef COLLECTION_H
+#define COLLECTION_H
+
+#include "fleet.hpp"
+#include "head_end.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Emulador dos ciclos de coleta de leituras (o caminho que em produção
+// consulta Hidrometer::getCounter de cada hidrômetro a partir do head-end).
+//
+// A frota é dividida em rotas contíguas; cada rota repete um ciclo de leitura
+// a cada cyclePeriodMs, com os inícios das rotas escalonados ao longo do
+// período. Um ciclo lê todos os hidrômetros da rota do mesmo snapshot
+// consistente da frota (publicado pelo dono da frota entre ticks), monta
+// lotes grandes no formato binário de head_end.hpp e os envia ao head-end por
+// um socket Unix, com até window lotes em voo por conexão. Hidrômetros que
+// não respondem (sorteio determinístico por seed, ciclo, id e tentativa) são
+// consultados de novo após retryDelayMs, até maxRetries vezes, ainda no
+// snapshot do ciclo. Ciclos vencidos são atendidos por um pequeno conjunto
+// de threads, cada uma com a sua conexão.
+
+// Contadores e status de toda a frota em um mesmo instante
+struct ReadingSnapshot {
+    uint64_t epoch = 0;
+    uint64_t tick = 0;                 // instante da frota (ticks do publicador)
+    std::vector<int32_t> counters;
+    std::vector<uint8_t> active;
+};
+
+// Publica snapshots da frota para os leitores (cópia única por publicação;
+// os leitores seguram o snapshot pelo tempo que precisarem)
+class SnapshotPublisher {
+public:
+    // Chamado pelo dono da frota, fora do tick
+    void publish(const StandardFleet& fleet, uint64_t tick);
+    std::shared_ptr<const ReadingSnapshot> acquire() const;
+
+private:
+    mutable std::mutex mutex;
+    std::shared_ptr<ReadingSnapshot> current;
+    std::shared_ptr<ReadingSnapshot> spare;    // buffers reaproveitados quando ninguém mais os lê
+    uint64_t epoch = 0;
+};
+
+struct CollectionConfig {
+    std::string socketPath = HEAD_END_DEFAULT_PATH;
+    uint32_t routes = 16;
+    uint32_t cycles = 5;               // ciclos por rota
+    uint32_t cyclePeriodMs = 1000;     // intervalo entre ciclos de uma rota
+    bool stagger = true;               // inícios das rotas espalhados no período
+    uint32_t batchSize = 8192;         // leituras por lote
+    uint32_t window = 8;               // lotes sem confirmação por conexão
+    float responseRate = 0.98f;        // probabilidade de resposta por tentativa
+    uint32_t maxRetries = 2;
+    uint32_t retryDelayMs = 50;
+    unsigned threads = 2;              // threads/conexões de coleta
+    uint64_t seed = 1;
+};
+
+struct CollectionStats {
+    uint64_t routeCycles = 0;
+    uint64_t readings = 0;             // leituras confirmadas pelo head-end
+    uint64_t missing = 0;              // sem resposta após todas as tentativas
+    uint64_t retries = 0;              // consultas repetidas
+    uint64_t batches = 0;
+    uint64_t bytes = 0;
+    uint64_t rejected = 0;             // lotes recusados pelo head-end
+    uint64_t checksum = 0;             // ver readingChecksum
+    double seconds = 0.0;
+    double readingsPerSecond = 0.0;
+    // Latência de ponta a ponta: início agendado do ciclo até a confirmação
+    // do último lote (incluindo as novas tentativas)
+    double latencyP50Ms = 0.0;
+    double latencyP99Ms = 0.0;
+    double latencyMaxMs = 0.0;
+    double startLagMaxMs = 0.0;        // maior atraso de início em relação à agenda
+};
+
+class CollectionEmulator {
+public:
+    CollectionEmulator(const CollectionConfig& config, const SnapshotPublisher& publisher);
+
+    // Executa todos os ciclos de todas as rotas; false se não conectou, não
+    // havia snapshot publicado ou o head-end recusou/perdeu lotes
+    bool run();
+
+    const CollectionStats& getStats() const;
+
+private:
+    CollectionConfig config;
+    const SnapshotPublisher& publisher;
+    CollectionStats stats;
+};
+
+#endif // COLLECTION_H
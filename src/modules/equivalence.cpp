@@ -0,0 +1,505 @@
+#include "equivalence.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+
+namespace {
+
+const int IMAGE_CHECK_TICKS = 5;      // imageUpdateLoop verifica a cada 500 ms
+const int32_t IMAGE_STEP_LITERS = 10; // marco entre imagens
+const size_t TRACE_BUDGET_BYTES = 8u << 20;   // traço de referência por thread
+const uint64_t GOLDEN = 0x9E3779B97F4A7C15ull;
+
+// Geometrias arbitrárias do cenário: entrada e saída (diâmetro, comprimento,
+// rugosidade em m). As últimas têm saída diferente da entrada, como os
+// hidrômetros perturbados da varredura Monte Carlo.
+const float CUSTOM_GEOMETRIES[][6] = {
+    {0.012f, 0.12f, 0.00005f, 0.012f, 0.12f, 0.00005f}, {0.018f, 0.17f, 0.00005f, 0.018f, 0.17f, 0.00005f},
+    {0.025f, 0.20f, 0.00005f, 0.025f, 0.20f, 0.00005f}, {0.032f, 0.25f, 0.0001f, 0.032f, 0.25f, 0.0001f},
+    {0.040f, 0.28f, 0.0001f, 0.040f, 0.28f, 0.0001f},   {0.015f, 0.30f, 0.00002f, 0.015f, 0.30f, 0.00002f},
+    {0.020f, 0.10f, 0.00015f, 0.020f, 0.10f, 0.00015f}, {0.065f, 0.35f, 0.0001f, 0.065f, 0.35f, 0.0001f},
+    {0.0153f, 0.098f, 0.00005f, 0.0148f, 0.103f, 0.00005f}, {0.0196f, 0.102f, 0.00005f, 0.0203f, 0.097f, 0.00005f},
+    {0.049f, 0.21f, 0.0001f, 0.051f, 0.19f, 0.0001f},   {0.025f, 0.20f, 0.00005f, 0.020f, 0.20f, 0.00005f},
+};
+const size_t CUSTOM_COUNT = sizeof(CUSTOM_GEOMETRIES) / sizeof(CUSTOM_GEOMETRIES[0]);
+const size_t KIND_COUNT = StandardFleet::MODEL_COUNT + CUSTOM_COUNT;
+
+uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+float unitFloat(uint64_t r) {
+    return static_cast<float>(r >> 40) * (1.0f / 16777216.0f);
+}
+
+enum class EventType : uint8_t { SET_FLOW, ACTIVATE, DEACTIVATE };
+
+struct Event {
+    EventType type;
+    float flow;
+};
+
+// Hidrômetro do cenário: tipo (modelo ou geometria arbitrária) e estado inicial
+struct MeterSpec {
+    uint32_t kind;      // < MODEL_COUNT: modelo; senão MODEL_COUNT + geometria
+    int32_t counter;
+    bool active;
+};
+
+MeterSpec meterSpec(const EquivalenceConfig& config, uint32_t meter) {
+    uint64_t r0 = mix(config.seed ^ (GOLDEN * (static_cast<uint64_t>(meter) + 1)));
+    uint64_t r1 = mix(r0 + GOLDEN);
+    MeterSpec spec;
+    bool custom = static_cast<double>(r0 >> 11) * (1.0 / 9007199254740992.0) < config.customFraction;
+    spec.kind = custom ? static_cast<uint32_t>(StandardFleet::MODEL_COUNT + r1 % CUSTOM_COUNT)
+                       : static_cast<uint32_t>(r1 % StandardFleet::MODEL_COUNT);
+    spec.counter = static_cast<int32_t>((r1 >> 20) % 1000000);
+    spec.active = (r1 >> 8) % 5 != 0;
+    return spec;
+}
+
+// Sequência de manobras de um hidrômetro (idêntica nos dois caminhos)
+class MeterScript {
+public:
+    MeterScript(const EquivalenceConfig& config, uint32_t meter, float maxFlow)
+        : state(mix(config.seed * GOLDEN ^ (static_cast<uint64_t>(meter) << 1 | 1))),
+          meanGap(config.eventInterval > 1.0f ? config.eventInterval : 1.0f),
+          maxFlow(maxFlow),
+          nextTick(0)
+    {
+        this->advance(0);
+    }
+
+    uint32_t getNextTick() const { return this->nextTick; }
+
+    Event take() {
+        uint64_t r = this->draw();
+        float u = unitFloat(r);
+        uint32_t k = static_cast<uint32_t>(r & 0xFF);
+        Event event;
+        event.flow = 0.0f;
+        if (k < 12) {
+            event.type = EventType::DEACTIVATE;
+        } else if (k < 40) {
+            event.type = EventType::ACTIVATE;
+        } else if (k < 64) {
+            // Em torno de maxFlow: aceito e limitado até +0.1%, recusado acima
+            event.type = EventType::SET_FLOW;
+            event.flow = this->maxFlow * (1.0f + 0.002f * (u - 0.25f));
+        } else if (k < 72) {
+            event.type = EventType::SET_FLOW;
+            event.flow = -u * this->maxFlow;
+        } else {
+            event.type = EventType::SET_FLOW;
+            event.flow = u * 1.02f * this->maxFlow;
+        }
+        this->advance(this->nextTick);
+        return event;
+    }
+
+private:
+    uint64_t draw() {
+        this->state += GOLDEN;
+        return mix(this->state);
+    }
+
+    // Intervalo geométrico (>= 1 tick) com média meanGap
+    void advance(uint32_t from) {
+        float u = unitFloat(this->draw());
+        float gap = -std::log1p(-u) * this->meanGap;
+        this->nextTick = from + 1 + static_cast<uint32_t>(std::min(gap, 1.0e9f));
+    }
+
+    uint64_t state;
+    float meanGap;
+    float maxFlow;
+    uint32_t nextTick;
+};
+
+struct TraceRecord {
+    uint32_t status;
+    float flowIN;
+    float flowOUT;
+    int32_t counter;
+};
+
+struct ImageCounter {
+    uint32_t images = 0;
+    int32_t next = 0;
+
+    void reset(int32_t counter) {
+        this->images = 0;
+        this->next = counter - counter % IMAGE_STEP_LITERS;
+    }
+
+    // Mesma regra do imageUpdateLoop: no máximo uma imagem por verificação
+    void check(int32_t counter) {
+        if (counter >= this->next) {
+            ++this->images;
+            this->next += IMAGE_STEP_LITERS;
+        }
+    }
+};
+
+double flowRelDiff(float a, float b) {
+    float scale = std::max(std::fabs(a), std::fabs(b));
+    return scale > 0.0f ? std::fabs(a - b) / scale : 0.0;
+}
+
+// Descarta std::cout enquanto os Hidrometer de referência são criados e
+// destruídos (eles registram no Logger); out pode ser o próprio std::cout
+class CoutSilence {
+public:
+    CoutSilence() : previous(std::cout.rdbuf(&sink)) {}
+    ~CoutSilence() { std::cout.rdbuf(this->previous); }
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+    NullBuffer sink;
+    std::streambuf* previous;
+};
+
+// Um Hidrometer por tipo, com a thread interna parada
+using ReferencePool = std::vector<std::unique_ptr<Hidrometer>>;
+
+ReferencePool makePool() {
+    ReferencePool pool;
+    pool.emplace_back(std::make_unique<Hidrometer>(Residential15::GEOMETRY));
+    pool.emplace_back(std::make_unique<Hidrometer>(Residential20::GEOMETRY));
+    pool.emplace_back(std::make_unique<Hidrometer>(Commercial50::GEOMETRY));
+    static_assert(StandardFleet::MODEL_COUNT == 3, "atualizar o conjunto de referência");
+    for (const float* g : CUSTOM_GEOMETRIES) {
+        pool.emplace_back(std::make_unique<Hidrometer>(g[0], g[1], g[2], g[3], g[4], g[5]));
+    }
+    for (auto& meter : pool) meter->shutdown();
+    return pool;
+}
+
+void applyReference(Hidrometer& meter, const Event& event) {
+    switch (event.type) {
+        case EventType::SET_FLOW: meter.getPipeIN()->setFlowRate(event.flow); break;
+        case EventType::ACTIVATE: meter.setStatus(true); break;
+        case EventType::DEACTIVATE: meter.setStatus(false); break;
+    }
+}
+
+void applyCandidate(CandidateEngine& engine, uint32_t meter, const Event& event) {
+    switch (event.type) {
+        case EventType::SET_FLOW: engine.setFlowRate(meter, event.flow); break;
+        case EventType::ACTIVATE: engine.setStatus(meter, true); break;
+        case EventType::DEACTIVATE: engine.setStatus(meter, false); break;
+    }
+}
+
+std::unique_ptr<StandardFleet> buildFleet(const std::vector<CandidateEngine::Meter>& meters) {
+    auto fleet = std::make_unique<StandardFleet>();
+    fleet->reserve(meters.size());
+    for (const CandidateEngine::Meter& meter : meters) {
+        if (meter.model == static_cast<int32_t>(StandardFleet::CUSTOM_MODEL)) {
+            fleet->addCustom(PipeGeometry{meter.diameter, meter.length, meter.roughness, 0.0f},
+                             PipeGeometry{meter.outDiameter, meter.outLength, meter.outRoughness, 0.0f},
+                             meter.counter, false);
+        } else {
+            fleet->add(static_cast<size_t>(meter.model), meter.counter, false);
+        }
+    }
+    return fleet;
+}
+
+} // namespace
+
+const char* FleetEngine::name() const { return "fleet"; }
+
+void FleetEngine::reset(const std::vector<Meter>& meters) { this->fleet = buildFleet(meters); }
+
+void FleetEngine::setFlowRate(uint32_t meter, float flow) { this->fleet->setFlowRate(meter, flow); }
+void FleetEngine::setStatus(uint32_t meter, bool active) {
+    if (active) this->fleet->activate(meter);
+    else this->fleet->deactivate(meter);
+}
+void FleetEngine::tick() { this->fleet->tick(); }
+MeterSnapshot FleetEngine::getSnapshot(uint32_t meter) const { return this->fleet->getSnapshot(meter); }
+
+const char* BehaviorTargetEngine::name() const { return "behavior"; }
+
+void BehaviorTargetEngine::reset(const std::vector<Meter>& meters) {
+    this->target.reset();
+    this->fleet = buildFleet(meters);
+    this->target = std::make_unique<FleetBehaviorTarget>(*this->fleet);
+}
+
+void BehaviorTargetEngine::setFlowRate(uint32_t meter, float flow) { this->target->setFlowRate(meter, flow); }
+void BehaviorTargetEngine::setStatus(uint32_t meter, bool active) {
+    if (active) this->target->activate(meter);
+    else this->target->deactivate(meter);
+}
+void BehaviorTargetEngine::tick() { this->target->advance(1); }
+MeterSnapshot BehaviorTargetEngine::getSnapshot(uint32_t meter) const { return this->target->getSnapshot(meter); }
+
+EquivalenceChecker::EquivalenceChecker(const EquivalenceConfig& config, EngineFactory factory)
+    : config(config),
+      factory(factory ? std::move(factory) : EngineFactory([]() { return std::make_unique<FleetEngine>(); })) {}
+
+bool EquivalenceChecker::run(std::ostream& out) {
+    const EquivalenceConfig& cfg = this->config;
+    if (cfg.meters == 0 || cfg.ticks == 0 || cfg.compareEvery == 0) {
+        out << "{\"type\":\"error\",\"message\":\"configuração de verificação inválida\"}" << std::endl;
+        return false;
+    }
+
+    // Vazão máxima de entrada por tipo (gera as mesmas manobras nos dois caminhos)
+    float maxFlowIn[KIND_COUNT] = {Residential15::GEOMETRY.in.maxFlow, Residential20::GEOMETRY.in.maxFlow,
+                                   Commercial50::GEOMETRY.in.maxFlow};
+    for (size_t g = 0; g < CUSTOM_COUNT; ++g) {
+        const float* geometry = CUSTOM_GEOMETRIES[g];
+        maxFlowIn[StandardFleet::MODEL_COUNT + g] = solvePipeGeometry(geometry[0], geometry[1], geometry[2]).maxFlow;
+    }
+
+    const uint32_t checkpoints = cfg.ticks / cfg.compareEvery;
+    const size_t recordBytes = std::max<size_t>(1, checkpoints) * sizeof(TraceRecord);
+    const uint32_t blockSize = static_cast<uint32_t>(std::min<size_t>(16384, std::max<size_t>(64, TRACE_BUDGET_BYTES / recordBytes)));
+    const uint32_t blocks = (cfg.meters + blockSize - 1) / blockSize;
+
+    unsigned threads = cfg.threads ? cfg.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min(threads, blocks));
+
+    std::vector<ReferencePool> pools;
+    std::vector<std::unique_ptr<CandidateEngine>> engines;
+    {
+        CoutSilence silence;
+        for (unsigned w = 0; w < threads; ++w) {
+            pools.push_back(makePool());
+            engines.push_back(this->factory());
+        }
+    }
+
+    this->divergences.clear();
+    this->summary = EquivalenceSummary();
+    std::mutex resultMutex;
+    std::atomic<uint32_t> nextBlock(0);
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&](unsigned w) {
+        ReferencePool& pool = pools[w];
+        CandidateEngine& engine = *engines[w];
+        std::vector<TraceRecord> trace(static_cast<size_t>(blockSize) * checkpoints);
+        std::vector<MeterSpec> specs;
+        std::vector<CandidateEngine::Meter> engineMeters;
+        std::vector<ImageCounter> referenceImages(blockSize), candidateImages(blockSize);
+        std::vector<MeterScript> scripts;
+        std::vector<MeterDivergence> found;
+        EquivalenceSummary local;
+
+        for (uint32_t b = nextBlock.fetch_add(1); b < blocks; b = nextBlock.fetch_add(1)) {
+            const uint32_t first = b * blockSize;
+            const uint32_t count = std::min(blockSize, cfg.meters - first);
+            specs.clear();
+            engineMeters.clear();
+            for (uint32_t i = 0; i < count; ++i) {
+                MeterSpec spec = meterSpec(cfg, first + i);
+                specs.push_back(spec);
+                CandidateEngine::Meter meter = {static_cast<int32_t>(spec.kind), 0.0f, 0.0f, 0.0f,
+                                                0.0f, 0.0f, 0.0f, spec.counter};
+                if (spec.kind >= StandardFleet::MODEL_COUNT) {
+                    const float* geometry = CUSTOM_GEOMETRIES[spec.kind - StandardFleet::MODEL_COUNT];
+                    meter.model = static_cast<int32_t>(StandardFleet::CUSTOM_MODEL);
+                    meter.diameter = geometry[0];
+                    meter.length = geometry[1];
+                    meter.roughness = geometry[2];
+                    meter.outDiameter = geometry[3];
+                    meter.outLength = geometry[4];
+                    meter.outRoughness = geometry[5];
+                }
+                engineMeters.push_back(meter);
+            }
+
+            // Referência: hidrômetro a hidrômetro, gravando o traço
+            for (uint32_t i = 0; i < count; ++i) {
+                const MeterSpec& spec = specs[i];
+                Hidrometer& meter = *pool[spec.kind];
+                meter.setStatus(false);
+                meter.getPipeIN()->setFlowRate(0.0f);
+                meter.getPipeOUT()->setFlowRate(0.0f);
+                meter.setCounter(spec.counter);
+                meter.setStatus(spec.active);
+
+                MeterScript script(cfg, first + i, maxFlowIn[spec.kind]);
+                ImageCounter& images = referenceImages[i];
+                images.reset(spec.counter);
+                TraceRecord* record = &trace[static_cast<size_t>(i) * checkpoints];
+                for (uint32_t t = 1; t <= cfg.ticks; ++t) {
+                    while (script.getNextTick() == t) {
+                        applyReference(meter, script.take());
+                        ++local.events;
+                    }
+                    meter.update();
+                    if (t % IMAGE_CHECK_TICKS == 0) images.check(meter.getCounter());
+                    if (t % cfg.compareEvery == 0 && record < &trace[static_cast<size_t>(i + 1) * checkpoints]) {
+                        MeterSnapshot snap = meter.getSnapshot();
+                        *record++ = TraceRecord{snap.status, snap.flowIN, snap.flowOUT, snap.counter};
+                    }
+                }
+            }
+
+            // Candidato: o bloco inteiro, tick a tick
+            engine.reset(engineMeters);
+            scripts.clear();
+            for (uint32_t i = 0; i < count; ++i) {
+                scripts.emplace_back(cfg, first + i, maxFlowIn[specs[i].kind]);
+                engine.setStatus(i, specs[i].active);
+                candidateImages[i].reset(specs[i].counter);
+            }
+            size_t firstDivergence = found.size();
+            std::vector<int32_t> divergenceIndex(count, -1);
+            std::vector<int64_t> maxCounter(count, 0);
+            std::vector<double> maxFlow(count, 0.0);
+
+            for (uint32_t t = 1; t <= cfg.ticks; ++t) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    while (scripts[i].getNextTick() == t) applyCandidate(engine, i, scripts[i].take());
+                }
+                engine.tick();
+                bool imageCheck = t % IMAGE_CHECK_TICKS == 0;
+                bool compare = t % cfg.compareEvery == 0 && t / cfg.compareEvery <= checkpoints;
+                if (!imageCheck && !compare) continue;
+
+                for (uint32_t i = 0; i < count; ++i) {
+                    MeterSnapshot snap = engine.getSnapshot(i);
+                    if (imageCheck) candidateImages[i].check(snap.counter);
+                    if (!compare) continue;
+
+                    const TraceRecord& ref = trace[static_cast<size_t>(i) * checkpoints + t / cfg.compareEvery - 1];
+                    int64_t counterDiff = std::llabs(static_cast<int64_t>(snap.counter) - ref.counter);
+                    double flowDiff = std::max(flowRelDiff(snap.flowIN, ref.flowIN), flowRelDiff(snap.flowOUT, ref.flowOUT));
+                    maxCounter[i] = std::max(maxCounter[i], counterDiff);
+                    maxFlow[i] = std::max(maxFlow[i], flowDiff);
+                    ++local.comparisons;
+
+                    if (divergenceIndex[i] >= 0) continue;
+                    const char* field = nullptr;
+                    double refValue = 0.0, candValue = 0.0;
+                    if (snap.status != ref.status) {
+                        field = "status"; refValue = ref.status; candValue = snap.status;
+                    } else if (flowRelDiff(snap.flowIN, ref.flowIN) > cfg.flowTolerance) {
+                        field = "flowIN"; refValue = ref.flowIN; candValue = snap.flowIN;
+                    } else if (flowRelDiff(snap.flowOUT, ref.flowOUT) > cfg.flowTolerance) {
+                        field = "flowOUT"; refValue = ref.flowOUT; candValue = snap.flowOUT;
+                    } else if (counterDiff > cfg.counterTolerance) {
+                        field = "counter"; refValue = ref.counter; candValue = snap.counter;
+                    }
+                    if (field) {
+                        divergenceIndex[i] = static_cast<int32_t>(found.size() - firstDivergence);
+                        found.push_back(MeterDivergence{first + i, static_cast<int32_t>(specs[i].kind), t, field,
+                                                        refValue, candValue, 0, 0.0});
+                    }
+                }
+            }
+
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t refImages = referenceImages[i].images;
+                uint32_t candImages = candidateImages[i].images;
+                local.referenceImages += refImages;
+                local.candidateImages += candImages;
+                uint32_t imageDiff = refImages > candImages ? refImages - candImages : candImages - refImages;
+                if (divergenceIndex[i] < 0 && imageDiff > cfg.imageTolerance) {
+                    divergenceIndex[i] = static_cast<int32_t>(found.size() - firstDivergence);
+                    found.push_back(MeterDivergence{first + i, static_cast<int32_t>(specs[i].kind), cfg.ticks, "images",
+                                                    static_cast<double>(refImages), static_cast<double>(candImages), 0, 0.0});
+                }
+                if (divergenceIndex[i] >= 0) {
+                    MeterDivergence& d = found[firstDivergence + divergenceIndex[i]];
+                    d.maxCounterDiff = maxCounter[i];
+                    d.maxFlowRelDiff = maxFlow[i];
+                }
+                local.maxCounterDiff = std::max(local.maxCounterDiff, maxCounter[i]);
+                local.maxFlowRelDiff = std::max(local.maxFlowRelDiff, maxFlow[i]);
+            }
+            local.meterTicks += static_cast<uint64_t>(count) * cfg.ticks;
+        }
+
+        std::lock_guard<std::mutex> lock(resultMutex);
+        this->divergences.insert(this->divergences.end(), found.begin(), found.end());
+        this->summary.meterTicks += local.meterTicks;
+        this->summary.comparisons += local.comparisons;
+        this->summary.events += local.events;
+        this->summary.referenceImages += local.referenceImages;
+        this->summary.candidateImages += local.candidateImages;
+        this->summary.maxCounterDiff = std::max(this->summary.maxCounterDiff, local.maxCounterDiff);
+        this->summary.maxFlowRelDiff = std::max(this->summary.maxFlowRelDiff, local.maxFlowRelDiff);
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned w = 1; w < threads; ++w) workers.emplace_back(worker, w);
+    worker(0);
+    for (std::thread& t : workers) t.join();
+
+    this->summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    this->summary.divergentMeters = this->divergences.size();
+    std::sort(this->divergences.begin(), this->divergences.end(),
+              [](const MeterDivergence& a, const MeterDivergence& b) { return a.meter < b.meter; });
+
+    {
+        CoutSilence silence;
+        pools.clear();
+    }
+
+    auto modelName = [](int32_t kind) {
+        return kind < static_cast<int32_t>(StandardFleet::MODEL_COUNT) ? StandardFleet::modelName(kind) : "custom";
+    };
+    out << std::setprecision(9);
+    size_t reported = std::min<size_t>(this->divergences.size(), cfg.maxReported);
+    for (size_t k = 0; k < reported; ++k) {
+        const MeterDivergence& d = this->divergences[k];
+        std::ostringstream line;
+        line << std::setprecision(9)
+             << "{\"type\":\"divergence\",\"meter\":" << d.meter
+             << ",\"model\":\"" << modelName(d.model) << "\""
+             << ",\"first_tick\":" << d.firstTick
+             << ",\"field\":\"" << d.field << "\""
+             << ",\"reference\":" << d.reference
+             << ",\"candidate\":" << d.candidate
+             << ",\"max_counter_diff\":" << d.maxCounterDiff
+             << ",\"max_flow_rel_diff\":" << d.maxFlowRelDiff << "}";
+        out << line.str() << std::endl;
+    }
+
+    bool passed = this->divergences.empty();
+    std::ostringstream line;
+    line << std::setprecision(9)
+         << "{\"type\":\"summary\",\"engine\":\"" << engines[0]->name() << "\""
+         << ",\"meters\":" << cfg.meters
+         << ",\"ticks\":" << cfg.ticks
+         << ",\"seed\":" << cfg.seed
+         << ",\"threads\":" << threads
+         << ",\"compare_every\":" << cfg.compareEvery
+         << ",\"counter_tolerance\":" << cfg.counterTolerance
+         << ",\"flow_tolerance\":" << cfg.flowTolerance
+         << ",\"image_tolerance\":" << cfg.imageTolerance
+         << ",\"events\":" << this->summary.events
+         << ",\"comparisons\":" << this->summary.comparisons
+         << ",\"divergent_meters\":" << this->summary.divergentMeters
+         << ",\"max_counter_diff\":" << this->summary.maxCounterDiff
+         << ",\"max_flow_rel_diff\":" << this->summary.maxFlowRelDiff
+         << ",\"reference_images\":" << this->summary.referenceImages
+         << ",\"candidate_images\":" << this->summary.candidateImages
+         << ",\"elapsed_s\":" << this->summary.seconds
+         << ",\"meter_ticks_per_s\":" << this->summary.meterTicks / this->summary.seconds
+         << ",\"passed\":" << (passed ? "true" : "false") << "}";
+    out << line.str() << std::endl;
+    return passed;
+}
+
+const std::vector<MeterDivergence>& EquivalenceChecker::getDivergences() const { return this->divergences; }
+const EquivalenceSummary& EquivalenceChecker::getSummary() const { return this->summary; }
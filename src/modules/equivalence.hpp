@@ -0,0 +1,146 @@
+#ifndef EQUIVALENCE_H
+#define EQUIVALENCE_H
+
+#include "behavior.hpp"
+#include "fleet.hpp"
+#include "hidrometer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// Verificador de equivalência (golden trace) entre o caminho de referência
+// (Hidrometer::update + Pipe::setFlowRate, hidrômetro a hidrômetro) e um
+// caminho otimizado (em lote, SIMD, preguiçoso...).
+//
+// Os dois caminhos recebem o mesmo cenário determinístico: modelo, contador
+// inicial e uma sequência de manobras por hidrômetro (vazões dentro, no
+// limite de tolerância de 0.1% e acima de maxFlow, valores negativos,
+// ativação e desativação), geradas a partir de (seed, id). A cada
+// compareEvery ticks os snapshots (status, vazões IN/OUT e contador) são
+// comparados, e os marcos de imagem de 10 L do imageUpdateLoop (verificados
+// a cada 5 ticks) são contados nos dois lados. Divergências acima das
+// tolerâncias são relatadas por hidrômetro.
+//
+// Os hidrômetros são processados em blocos distribuídos entre threads; a
+// referência reutiliza alguns Hidrometer por thread (um por geometria, com a
+// thread interna parada) e grava o traço de cada hidrômetro do bloco, que é
+// comparado com o caminho otimizado avançado tick a tick sobre o bloco todo.
+
+// Caminho otimizado sob teste. Uma instância por thread de trabalho; ids
+// são locais ao bloco (0..n-1, na ordem de reset).
+class CandidateEngine {
+public:
+    struct Meter {
+        int32_t model;      // índice em StandardFleet ou CUSTOM_MODEL
+        float diameter;     // geometria de entrada (apenas modelos arbitrários)
+        float length;
+        float roughness;
+        float outDiameter;  // geometria de saída (apenas modelos arbitrários)
+        float outLength;
+        float outRoughness;
+        int32_t counter;    // contador inicial (litros)
+    };
+
+    virtual ~CandidateEngine() = default;
+    virtual const char* name() const = 0;
+    virtual void reset(const std::vector<Meter>& meters) = 0;
+    virtual void setFlowRate(uint32_t meter, float flow) = 0;
+    virtual void setStatus(uint32_t meter, bool active) = 0;
+    virtual void tick() = 0;   // um passo de 0.1s
+    virtual MeterSnapshot getSnapshot(uint32_t meter) const = 0;
+};
+
+// Caminho em lote padrão: StandardFleet
+class FleetEngine : public CandidateEngine {
+public:
+    const char* name() const override;
+    void reset(const std::vector<Meter>& meters) override;
+    void setFlowRate(uint32_t meter, float flow) override;
+    void setStatus(uint32_t meter, bool active) override;
+    void tick() override;
+    MeterSnapshot getSnapshot(uint32_t meter) const override;
+
+private:
+    std::unique_ptr<StandardFleet> fleet;
+};
+
+// Integração preguiçosa do modo comportamentos: FleetBehaviorTarget sobre
+// uma StandardFleet. tick() só avança o tempo; cada hidrômetro é integrado
+// de uma vez nas suas manobras e lido por projeção (sem sync())
+class BehaviorTargetEngine : public CandidateEngine {
+public:
+    const char* name() const override;
+    void reset(const std::vector<Meter>& meters) override;
+    void setFlowRate(uint32_t meter, float flow) override;
+    void setStatus(uint32_t meter, bool active) override;
+    void tick() override;
+    MeterSnapshot getSnapshot(uint32_t meter) const override;
+
+private:
+    std::unique_ptr<StandardFleet> fleet;
+    std::unique_ptr<FleetBehaviorTarget> target;
+};
+
+using EngineFactory = std::function<std::unique_ptr<CandidateEngine>()>;
+
+struct EquivalenceConfig {
+    uint32_t meters = 10000;
+    uint32_t ticks = 600;            // 60 s simulados
+    uint64_t seed = 1;
+    unsigned threads = 0;            // 0 = todos os núcleos
+    uint32_t compareEvery = 1;       // intervalo entre comparações (ticks)
+    float eventInterval = 20.0f;     // intervalo médio entre manobras (ticks)
+    float customFraction = 0.01f;    // fração com geometria arbitrária
+    int32_t counterTolerance = 0;    // litros
+    float flowTolerance = 0.0f;      // relativa
+    uint32_t imageTolerance = 0;     // imagens
+    uint32_t maxReported = 20;       // linhas de divergência emitidas
+};
+
+// Divergência de um hidrômetro (primeira comparação fora da tolerância e
+// maiores diferenças ao longo do cenário)
+struct MeterDivergence {
+    uint32_t meter;
+    int32_t model;
+    uint32_t firstTick;
+    const char* field;              // "status", "flowIN", "flowOUT", "counter" ou "images"
+    double reference;
+    double candidate;
+    int64_t maxCounterDiff;
+    double maxFlowRelDiff;
+};
+
+struct EquivalenceSummary {
+    uint64_t meterTicks = 0;
+    uint64_t comparisons = 0;
+    uint64_t events = 0;
+    uint64_t divergentMeters = 0;
+    int64_t maxCounterDiff = 0;
+    double maxFlowRelDiff = 0.0;
+    uint64_t referenceImages = 0;
+    uint64_t candidateImages = 0;
+    double seconds = 0.0;
+};
+
+class EquivalenceChecker {
+public:
+    explicit EquivalenceChecker(const EquivalenceConfig& config, EngineFactory factory = nullptr);
+
+    // Executa o cenário; escreve linhas JSON de divergência (até maxReported)
+    // e um resumo. true se nenhum hidrômetro divergiu além das tolerâncias.
+    bool run(std::ostream& out);
+
+    const std::vector<MeterDivergence>& getDivergences() const;
+    const EquivalenceSummary& getSummary() const;
+
+private:
+    EquivalenceConfig config;
+    EngineFactory factory;
+    std::vector<MeterDivergence> divergences;
+    EquivalenceSummary summary;
+};
+
+#endif // EQUIVALENCE_H
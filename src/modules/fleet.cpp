@@ -0,0 +1,173 @@
+#include "fleet.hpp"
+
+// Instâncias explícitas: os kernels de tick dos modelos pré-definidos são
+// gerados aqui, com as vazões máximas como constantes, e vetorizados em -O3
+template class ModelBatch<Residential15>;
+template class ModelBatch<Residential20>;
+template class ModelBatch<Commercial50>;
+
+bool GeometryBatch::registerGeometry(float diameter, float length, float roughness, uint16_t& index) {
+    PipeGeometry pipe{diameter, length, roughness, 0.0f};
+    return this->registerGeometry(pipe, pipe, index);
+}
+
+bool GeometryBatch::registerGeometry(const PipeGeometry& in, const PipeGeometry& out, uint16_t& index) {
+    for (const PipeGeometry* pipe : {&in, &out}) {
+        if (!(pipe->diameter > 0.0f) || !(pipe->length > 0.0f) || !(pipe->roughness >= 0.0f)) {
+            return false;
+        }
+    }
+
+    std::array<uint32_t, 6> key = {fleet_detail::bitsFromFlow(in.diameter), fleet_detail::bitsFromFlow(in.length),
+                                   fleet_detail::bitsFromFlow(in.roughness), fleet_detail::bitsFromFlow(out.diameter),
+                                   fleet_detail::bitsFromFlow(out.length), fleet_detail::bitsFromFlow(out.roughness)};
+    auto it = this->known.find(key);
+    if (it != this->known.end()) {
+        index = it->second;
+        return true;
+    }
+    if (this->geometries.size() >= MAX_GEOMETRIES) {
+        return false;
+    }
+
+    // Geometria nova: única solução de Darcy-Weisbach para ela (IN e OUT
+    // iguais são resolvidos uma vez)
+    MeterGeometry solved;
+    if (key[0] == key[3] && key[1] == key[4] && key[2] == key[5]) {
+        solved = solveMeterGeometry(in.diameter, in.length, in.roughness);
+    } else {
+        solved = solveMeterGeometry(in, out);
+    }
+    ++this->solves;
+    index = static_cast<uint16_t>(this->geometries.size());
+    this->geometries.push_back(solved);
+    this->maxOut.push_back(solved.out.maxFlow);
+    this->known.emplace(key, index);
+    return true;
+}
+
+const MeterGeometry& GeometryBatch::getGeometry(uint16_t index) const { return this->geometries[index]; }
+uint16_t GeometryBatch::getGeometryIndex(uint32_t i) const { return this->geometry[i]; }
+size_t GeometryBatch::geometryCount() const { return this->geometries.size(); }
+uint64_t GeometryBatch::getSolveCount() const { return this->solves; }
+
+uint32_t GeometryBatch::add(uint16_t geometry, int32_t counter, bool active) {
+    this->geometry.push_back(geometry);
+    this->flowIN.push_back(active ? 0u : fleet_detail::INACTIVE_BIT);
+    this->counterFloat.push_back(static_cast<float>(counter));
+    this->flowOUT.push_back(0.0f);
+    return static_cast<uint32_t>(this->flowIN.size() - 1);
+}
+
+void GeometryBatch::reserve(size_t n) {
+    this->geometry.reserve(n);
+    this->flowIN.reserve(n);
+    this->counterFloat.reserve(n);
+    this->flowOUT.reserve(n);
+}
+
+void GeometryBatch::resize(size_t n) {
+    this->geometry.resize(n, 0);
+    this->flowIN.resize(n, fleet_detail::INACTIVE_BIT);
+    this->counterFloat.resize(n, 0.0f);
+    this->flowOUT.resize(n, 0.0f);
+}
+
+void GeometryBatch::init(uint32_t i, uint16_t geometry, int32_t counter, bool active) {
+    this->geometry[i] = geometry;
+    this->flowIN[i] = active ? 0u : fleet_detail::INACTIVE_BIT;
+    this->counterFloat[i] = static_cast<float>(counter);
+    this->flowOUT[i] = 0.0f;
+}
+
+// Mesma regra de Pipe::setFlowRate, com a vazão máxima da geometria do hidrômetro
+bool GeometryBatch::setFlowRate(uint32_t i, float flow) {
+    float maxFlow = this->geometries[this->geometry[i]].in.maxFlow;
+    if (flow < 0.0f || flow > maxFlow * (1.0f + FLEET_FLOW_TOLERANCE)) {
+        return false;
+    }
+    uint32_t status = this->flowIN[i] & fleet_detail::INACTIVE_BIT;
+    this->flowIN[i] = status | fleet_detail::bitsFromFlow(flow < maxFlow ? flow : maxFlow);
+    return true;
+}
+
+void GeometryBatch::setStatus(uint32_t i, bool active) {
+    uint32_t flow = this->flowIN[i] & fleet_detail::FLOW_MASK;
+    this->flowIN[i] = active ? flow : (flow | fleet_detail::INACTIVE_BIT);
+}
+
+void GeometryBatch::setCounter(uint32_t i, int32_t value) { this->counterFloat[i] = static_cast<float>(value); }
+void GeometryBatch::addLiters(uint32_t i, float liters) { this->counterFloat[i] += liters; }
+float GeometryBatch::getLiters(uint32_t i) const { return this->counterFloat[i]; }
+
+namespace {
+
+// Kernel de tickKernel com a vazão OUT máxima buscada na tabela de geometrias
+void geometryTickKernel(size_t n, float dt,
+                        const uint16_t* __restrict geometry,
+                        const float* __restrict maxOutTable,
+                        const uint32_t* __restrict flowIN,
+                        float* __restrict flowOUT,
+                        float* __restrict counterFloat) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t bits = flowIN[i];
+        float on = static_cast<float>(static_cast<int32_t>((bits >> 31) ^ 1u));
+        float out = fleet_detail::flowFromBits(bits & fleet_detail::FLOW_MASK) * FLEET_LOSS_FACTOR * on;
+
+        float maxOut = maxOutTable[geometry[i]];
+        float previous = flowOUT[i];
+        float accepted = out < maxOut ? out : maxOut;
+        flowOUT[i] = out > maxOut * (1.0f + FLEET_FLOW_TOLERANCE) ? previous : accepted;
+
+        counterFloat[i] += (out * dt) * 1000.0f;
+    }
+}
+
+} // namespace
+
+void GeometryBatch::tick(float dt) {
+    geometryTickKernel(this->flowIN.size(), dt, this->geometry.data(), this->maxOut.data(), this->flowIN.data(),
+                       this->flowOUT.data(), this->counterFloat.data());
+    ++this->ticks;
+}
+
+void GeometryBatch::advance(uint32_t i, uint64_t ticks, float dt) {
+    if (ticks == 0) return;
+    geometryTickKernel(1, dt, &this->geometry[i], this->maxOut.data(), &this->flowIN[i], &this->flowOUT[i],
+                       &this->counterFloat[i]);
+    this->counterFloat[i] = fleet_detail::accumulate(
+        this->counterFloat[i], fleet_detail::tickIncrement(this->flowIN[i], dt), ticks - 1);
+}
+
+float GeometryBatch::getMaxFlow(uint32_t i) const { return this->geometries[this->geometry[i]].in.maxFlow; }
+
+MeterSnapshot GeometryBatch::getSnapshot(uint32_t i) const {
+    MeterSnapshot snap;
+    snap.status = (this->flowIN[i] & fleet_detail::INACTIVE_BIT) ? 0u : 1u;
+    snap.flowIN = fleet_detail::flowFromBits(this->flowIN[i] & fleet_detail::FLOW_MASK);
+    snap.flowOUT = this->flowOUT[i];
+    snap.counter = static_cast<int32_t>(this->counterFloat[i]);
+    snap.ticks = this->ticks;
+    return snap;
+}
+
+MeterSnapshot GeometryBatch::getSnapshot(uint32_t i, uint64_t pending, float dt) const {
+    MeterSnapshot snap = this->getSnapshot(i);
+    if (pending == 0) return snap;
+    uint32_t bits = this->flowIN[i];
+    float out = snap.flowOUT;
+    float counter = this->counterFloat[i];
+    geometryTickKernel(1, dt, &this->geometry[i], this->maxOut.data(), &bits, &out, &counter);
+    snap.flowOUT = out;
+    snap.counter = static_cast<int32_t>(
+        fleet_detail::accumulate(counter, fleet_detail::tickIncrement(bits, dt), pending - 1));
+    return snap;
+}
+
+size_t GeometryBatch::size() const { return this->flowIN.size(); }
+
+size_t GeometryBatch::memoryBytes() const {
+    return this->geometry.capacity() * sizeof(uint16_t) + this->flowIN.capacity() * sizeof(uint32_t) +
+           (this->counterFloat.capacity() + this->flowOUT.capacity()) * sizeof(float) +
+           this->geometries.capacity() * sizeof(MeterGeometry) + this->maxOut.capacity() * sizeof(float);
+}
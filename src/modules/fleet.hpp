@@ -0,0 +1,568 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "hidrometer.hpp"
+#include "meter_model.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#define FLEET_TICK_SECONDS 0.1f       // mesmo passo de Hidrometer::update
+#define FLEET_FLOW_TOLERANCE 0.001f   // mesma tolerância de Pipe::setFlowRate
+#define FLEET_LOSS_FACTOR 0.9f        // perda de 10% entre IN e OUT
+
+// Frota em lote, sem threads por hidrômetro: cada modelo tem seu próprio lote
+// SoA e seu próprio kernel de tick, instanciado com as vazões máximas como
+// constantes de compilação. Frotas mistas percorrem a tupla de lotes sem
+// despacho virtual. Não é thread-safe: um único escritor chama tick() e os
+// métodos de controle.
+
+namespace fleet_detail {
+
+const uint32_t INACTIVE_BIT = 0x80000000u;   // bit de sinal da vazão IN = hidrômetro inativo
+const uint32_t FLOW_MASK = 0x7FFFFFFFu;
+
+inline float flowFromBits(uint32_t bits) {
+    float flow;
+    std::memcpy(&flow, &bits, sizeof(flow));
+    return flow;
+}
+
+inline uint32_t bitsFromFlow(float flow) {
+    uint32_t bits;
+    std::memcpy(&bits, &flow, sizeof(bits));
+    return bits;
+}
+
+// Mesma semântica de Hidrometer::update por hidrômetro, sem desvios:
+// OUT = IN*0.9 aceito por Pipe::setFlowRate (ou mantido se acima da tolerância),
+// contador em litros acumulado em float. flowIN traz a vazão IN (float) com o
+// status no bit de sinal; flowOUT só é gravado quando o modelo pode recusar OUT.
+template <typename Model, bool StoresFlowOut>
+inline void tickKernel(size_t n, float dt,
+                       const uint32_t* __restrict flowIN,
+                       float* __restrict flowOUT,
+                       float* __restrict counterFloat) {
+    constexpr float maxOut = Model::GEOMETRY.out.maxFlow;
+    constexpr float limitOut = maxOut * (1.0f + FLEET_FLOW_TOLERANCE);
+
+    for (size_t i = 0; i < n; ++i) {
+        // Seleções sem desvio (status 0/1 como fator) para o laço vetorizar
+        uint32_t bits = flowIN[i];
+        float on = static_cast<float>(static_cast<int32_t>((bits >> 31) ^ 1u));
+        float out = flowFromBits(bits & FLOW_MASK) * FLEET_LOSS_FACTOR * on;
+
+        if constexpr (StoresFlowOut) {
+            float previous = flowOUT[i];
+            float accepted = out < maxOut ? out : maxOut;
+            flowOUT[i] = out > limitOut ? previous : accepted;
+        }
+
+        counterFloat[i] += (out * dt) * 1000.0f; // inativo soma 0
+    }
+}
+
+// Litros somados por tick pelo kernel (mesma conta de tickKernel)
+inline float tickIncrement(uint32_t bits, float dt) {
+    float on = static_cast<float>(static_cast<int32_t>((bits >> 31) ^ 1u));
+    float out = flowFromBits(bits & FLOW_MASK) * FLEET_LOSS_FACTOR * on;
+    return (out * dt) * 1000.0f;
+}
+
+// counter += increment repetido ticks vezes em float, com o mesmo resultado
+// bit a bit das somas uma a uma, em O(binades) em vez de O(ticks). Dentro de
+// um binade [2^(e-1), 2^e) todo múltiplo do ulp u é representável, então
+// RN(c + x) = c + d com d constante enquanto a soma não passa de 2^e; só no
+// empate (x - d = ±u/2) d depende da paridade de c, e depois de uma soma
+// arredondada para par ele também fica constante. Quando d é 0 o contador
+// está preso e nenhuma soma o altera (o que o tick a tick também faz).
+inline float accumulate(float counter, float increment, uint64_t ticks) {
+    while (ticks > 0) {
+        float next = counter + increment;
+        float step = next - counter;
+        if (step == 0.0f) break;
+        if (!(counter >= 1.0f)) {   // negativos e frações: uma soma por vez
+            counter = next;
+            --ticks;
+            continue;
+        }
+        int e = 0;
+        std::frexp(counter, &e);
+        const double ulp = std::ldexp(1.0, e - 24);
+        bool tie = std::fabs(static_cast<double>(increment) - static_cast<double>(step)) * 2.0 == ulp;
+        uint64_t units = static_cast<uint64_t>(counter / ulp);
+        uint64_t stepUnits = static_cast<uint64_t>(step / ulp);
+        uint64_t room = ((1ull << 24) - 1 - units) / stepUnits;   // somas que ficam abaixo de 2^e
+        if (room == 0 || (tie && (units & 1u))) {
+            counter = next;
+            --ticks;
+            continue;
+        }
+        uint64_t jump = room < ticks ? room : ticks;
+        counter = static_cast<float>(static_cast<double>(counter) + static_cast<double>(jump) * step);
+        ticks -= jump;
+    }
+    return counter;
+}
+
+template <typename Model, typename... Models>
+struct ModelIndex;
+
+template <typename Model, typename... Rest>
+struct ModelIndex<Model, Model, Rest...> {
+    static constexpr size_t value = 0;
+};
+
+template <typename Model, typename Other, typename... Rest>
+struct ModelIndex<Model, Other, Rest...> {
+    static constexpr size_t value = 1 + ModelIndex<Model, Rest...>::value;
+};
+
+} // namespace fleet_detail
+
+// Lote SoA compacto de hidrômetros do mesmo modelo. A geometria vem do tipo
+// do modelo (nada por hidrômetro); o estado é a vazão IN com o status no bit
+// de sinal e o contador em float (o inteiro é derivado dele). A vazão OUT só é
+// guardada se o modelo pode ter OUT = IN*0.9 recusado por Pipe::setFlowRate;
+// caso contrário ela é uma função de IN e do status.
+template <typename Model>
+class ModelBatch {
+public:
+    static constexpr float MAX_FLOW_IN = Model::GEOMETRY.in.maxFlow;
+    static constexpr float MAX_FLOW_OUT = Model::GEOMETRY.out.maxFlow;
+    static constexpr bool STORES_FLOW_OUT =
+        MAX_FLOW_IN * FLEET_LOSS_FACTOR > MAX_FLOW_OUT * (1.0f + FLEET_FLOW_TOLERANCE);
+    static constexpr size_t BYTES_PER_METER =
+        sizeof(uint32_t) + sizeof(float) + (STORES_FLOW_OUT ? sizeof(float) : 0);
+
+    uint32_t add(int32_t counter, bool active) {
+        this->flowIN.push_back(active ? 0u : fleet_detail::INACTIVE_BIT);
+        this->counterFloat.push_back(static_cast<float>(counter));
+        if (STORES_FLOW_OUT) this->flowOUT.push_back(0.0f);
+        return static_cast<uint32_t>(this->flowIN.size() - 1);
+    }
+
+    void reserve(size_t n) {
+        this->flowIN.reserve(n);
+        this->counterFloat.reserve(n);
+        if (STORES_FLOW_OUT) this->flowOUT.reserve(n);
+    }
+
+    // Carga em massa: resize() uma vez e init() em paralelo para índices distintos
+    void resize(size_t n) {
+        this->flowIN.resize(n, fleet_detail::INACTIVE_BIT);
+        this->counterFloat.resize(n, 0.0f);
+        if (STORES_FLOW_OUT) this->flowOUT.resize(n, 0.0f);
+    }
+
+    void init(uint32_t i, int32_t counter, bool active) {
+        this->flowIN[i] = active ? 0u : fleet_detail::INACTIVE_BIT;
+        this->counterFloat[i] = static_cast<float>(counter);
+        if (STORES_FLOW_OUT) this->flowOUT[i] = 0.0f;
+    }
+
+    // Mesma regra de Pipe::setFlowRate: negativo ou acima de max*(1+0.1%) é ignorado
+    bool setFlowRate(uint32_t i, float flow) {
+        if (flow < 0.0f || flow > MAX_FLOW_IN * (1.0f + FLEET_FLOW_TOLERANCE)) {
+            return false;
+        }
+        uint32_t status = this->flowIN[i] & fleet_detail::INACTIVE_BIT;
+        this->flowIN[i] = status | fleet_detail::bitsFromFlow(flow < MAX_FLOW_IN ? flow : MAX_FLOW_IN);
+        return true;
+    }
+
+    void setStatus(uint32_t i, bool active) {
+        uint32_t flow = this->flowIN[i] & fleet_detail::FLOW_MASK;
+        this->flowIN[i] = active ? flow : (flow | fleet_detail::INACTIVE_BIT);
+    }
+
+    void setCounter(uint32_t i, int32_t value) { this->counterFloat[i] = static_cast<float>(value); }
+    // Volume integrado fora do kernel (ex.: transitórios de FlowDynamics)
+    void addLiters(uint32_t i, float liters) { this->counterFloat[i] += liters; }
+    float getLiters(uint32_t i) const { return this->counterFloat[i]; }
+
+    void tick(float dt) {
+        fleet_detail::tickKernel<Model, STORES_FLOW_OUT>(this->flowIN.size(), dt, this->flowIN.data(),
+                                                         this->flowOUT.data(), this->counterFloat.data());
+        ++this->ticks;
+    }
+
+    // Só o hidrômetro i avança ticks passos de dt, sem contar tick: mesmo
+    // resultado bit a bit de ticks chamadas do kernel com a vazão atual
+    // (integração preguiçosa de quem tem vazão constante entre manobras)
+    void advance(uint32_t i, uint64_t ticks, float dt = FLEET_TICK_SECONDS) {
+        if (ticks == 0) return;
+        fleet_detail::tickKernel<Model, STORES_FLOW_OUT>(1, dt, &this->flowIN[i],
+                                                         STORES_FLOW_OUT ? &this->flowOUT[i] : nullptr,
+                                                         &this->counterFloat[i]);
+        this->counterFloat[i] = fleet_detail::accumulate(
+            this->counterFloat[i], fleet_detail::tickIncrement(this->flowIN[i], dt), ticks - 1);
+    }
+
+    bool isActive(uint32_t i) const { return !(this->flowIN[i] & fleet_detail::INACTIVE_BIT); }
+    float getFlowIN(uint32_t i) const { return fleet_detail::flowFromBits(this->flowIN[i] & fleet_detail::FLOW_MASK); }
+    int32_t getCounter(uint32_t i) const { return static_cast<int32_t>(this->counterFloat[i]); }
+
+    // Sem OUT guardado, o valor é o que o kernel calcularia com IN e status atuais
+    float getFlowOUT(uint32_t i) const {
+        if (STORES_FLOW_OUT) return this->flowOUT[i];
+        if (!this->isActive(i)) return 0.0f;
+        float out = this->getFlowIN(i) * FLEET_LOSS_FACTOR;
+        return out < MAX_FLOW_OUT ? out : MAX_FLOW_OUT;
+    }
+
+    MeterSnapshot getSnapshot(uint32_t i) const {
+        MeterSnapshot snap;
+        snap.status = this->isActive(i) ? 1u : 0u;
+        snap.flowIN = this->getFlowIN(i);
+        snap.flowOUT = this->getFlowOUT(i);
+        snap.counter = this->getCounter(i);
+        snap.ticks = this->ticks;
+        return snap;
+    }
+
+    // Snapshot que advance(i, pending, dt) deixaria, sem alterar o lote
+    MeterSnapshot getSnapshot(uint32_t i, uint64_t pending, float dt = FLEET_TICK_SECONDS) const {
+        MeterSnapshot snap = this->getSnapshot(i);
+        if (pending == 0) return snap;
+        uint32_t bits = this->flowIN[i];
+        float out = snap.flowOUT;
+        float counter = this->counterFloat[i];
+        fleet_detail::tickKernel<Model, STORES_FLOW_OUT>(1, dt, &bits, &out, &counter);
+        snap.flowOUT = out;
+        snap.counter = static_cast<int32_t>(
+            fleet_detail::accumulate(counter, fleet_detail::tickIncrement(bits, dt), pending - 1));
+        return snap;
+    }
+
+    size_t size() const { return this->flowIN.size(); }
+
+    // Bytes efetivamente reservados pelo lote
+    size_t memoryBytes() const {
+        return this->flowIN.capacity() * sizeof(uint32_t) + this->counterFloat.capacity() * sizeof(float) +
+               this->flowOUT.capacity() * sizeof(float);
+    }
+
+private:
+    std::vector<uint32_t> flowIN;      // bits do float da vazão IN | INACTIVE_BIT
+    std::vector<float> counterFloat;   // litros
+    std::vector<float> flowOUT;        // vazio quando !STORES_FLOW_OUT
+    uint32_t ticks = 0;
+};
+
+// Lote de hidrômetros com geometria conhecida só em tempo de execução (ex.:
+// arquivo de definição da frota). Geometrias iguais são registradas uma única
+// vez e a vazão máxima é resolvida só no registro; cada hidrômetro guarda o
+// índice de 16 bits da sua geometria e a vazão OUT (o modelo não é conhecido
+// em compilação). Mesma interface de ModelBatch.
+class GeometryBatch {
+public:
+    static constexpr size_t MAX_GEOMETRIES = 65536;
+    static constexpr size_t BYTES_PER_METER = sizeof(uint16_t) + sizeof(uint32_t) + 2 * sizeof(float);
+
+    // Índice da geometria (IN = OUT = diâmetro, comprimento, rugosidade);
+    // resolve Darcy-Weisbach apenas se ela ainda não foi registrada
+    bool registerGeometry(float diameter, float length, float roughness, uint16_t& index);
+    // Entrada e saída com dimensões próprias (maxFlow de in/out é ignorado e resolvido)
+    bool registerGeometry(const PipeGeometry& in, const PipeGeometry& out, uint16_t& index);
+    const MeterGeometry& getGeometry(uint16_t index) const;
+    uint16_t getGeometryIndex(uint32_t i) const;   // geometria do hidrômetro i
+    size_t geometryCount() const;
+    uint64_t getSolveCount() const;
+
+    uint32_t add(uint16_t geometry, int32_t counter, bool active);
+    void reserve(size_t n);
+    void resize(size_t n);
+    void init(uint32_t i, uint16_t geometry, int32_t counter, bool active);
+
+    bool setFlowRate(uint32_t i, float flow);
+    void setStatus(uint32_t i, bool active);
+    void setCounter(uint32_t i, int32_t value);
+    void addLiters(uint32_t i, float liters);
+    float getLiters(uint32_t i) const;
+    void tick(float dt);
+    void advance(uint32_t i, uint64_t ticks, float dt = FLEET_TICK_SECONDS);
+
+    float getMaxFlow(uint32_t i) const;
+    MeterSnapshot getSnapshot(uint32_t i) const;
+    MeterSnapshot getSnapshot(uint32_t i, uint64_t pending, float dt = FLEET_TICK_SECONDS) const;
+    size_t size() const;
+    size_t memoryBytes() const;
+
+private:
+    std::vector<MeterGeometry> geometries;
+    std::vector<float> maxOut;                           // por geometria, para o kernel
+    std::map<std::array<uint32_t, 6>, uint16_t> known;   // bits de (d, l, r) de IN e OUT -> índice
+    std::vector<uint16_t> geometry;
+    std::vector<uint32_t> flowIN;      // bits do float da vazão IN | INACTIVE_BIT
+    std::vector<float> counterFloat;
+    std::vector<float> flowOUT;
+    uint32_t ticks = 0;
+    uint64_t solves = 0;
+};
+
+template <typename... Models>
+class Fleet {
+public:
+    static constexpr size_t MODEL_COUNT = sizeof...(Models);
+    static constexpr uint32_t CUSTOM_MODEL = MODEL_COUNT;       // lote de geometrias de execução
+    static constexpr uint32_t MODEL_SHIFT = 28;                 // modelo nos 4 bits altos da referência
+    static constexpr uint32_t INDEX_MASK = (1u << MODEL_SHIFT) - 1;
+    static_assert(MODEL_COUNT < 16, "no máximo 15 modelos por frota (mais o lote de geometrias)");
+
+    // Posição de um hidrômetro: lote do modelo e índice dentro do lote
+    struct MeterRef {
+        uint32_t model;
+        uint32_t index;
+    };
+
+    template <typename Model>
+    static constexpr size_t modelIndex() {
+        return fleet_detail::ModelIndex<Model, Models...>::value;
+    }
+
+    // Índice do modelo pelo nome (ex.: "R15"), -1 se desconhecido
+    static int findModel(const std::string& name) {
+        const char* names[] = {Models::NAME...};
+        for (size_t m = 0; m < MODEL_COUNT; ++m) {
+            if (name == names[m]) return static_cast<int>(m);
+        }
+        return -1;
+    }
+
+    static const char* modelName(size_t model) {
+        const char* names[] = {Models::NAME...};
+        return model < MODEL_COUNT ? names[model] : (model == CUSTOM_MODEL ? "custom" : "");
+    }
+
+    static float modelMaxFlow(size_t model) {
+        const float flows[] = {Models::GEOMETRY.in.maxFlow...};
+        return model < MODEL_COUNT ? flows[model] : 0.0f;
+    }
+
+    static const MeterGeometry& modelGeometry(size_t model) {
+        static constexpr MeterGeometry geometries[] = {Models::GEOMETRY...};
+        return geometries[model < MODEL_COUNT ? model : 0];
+    }
+
+    // Geometria de qualquer hidrômetro (modelo de compilação ou lote de geometrias)
+    const MeterGeometry& getGeometry(uint32_t id) const {
+        const MeterRef ref = this->getRef(id);
+        return ref.model == CUSTOM_MODEL ? this->custom.getGeometry(this->custom.getGeometryIndex(ref.index))
+                                         : modelGeometry(ref.model);
+    }
+
+    // Até 2^28 hidrômetros por modelo
+    template <typename Model>
+    uint32_t add(int32_t counter = 0, bool active = false) {
+        constexpr size_t m = modelIndex<Model>();
+        uint32_t index = std::get<m>(this->batches).add(counter, active);
+        this->meters.push_back(static_cast<uint32_t>(m) << MODEL_SHIFT | index);
+        return static_cast<uint32_t>(this->meters.size() - 1);
+    }
+
+    // Modelo escolhido em tempo de execução (ex.: arquivo de definição da frota)
+    bool add(size_t model, int32_t counter, bool active, uint32_t* id = nullptr) {
+        if (model >= MODEL_COUNT) return false;
+        uint32_t index = 0;
+        this->visitModels(static_cast<uint32_t>(model), [&](auto& batch) { index = batch.add(counter, active); });
+        this->meters.push_back(static_cast<uint32_t>(model) << MODEL_SHIFT | index);
+        if (id) *id = static_cast<uint32_t>(this->meters.size() - 1);
+        return true;
+    }
+
+    // Hidrômetro com geometria arbitrária (vai para o lote de geometrias)
+    bool addCustom(float diameter, float length, float roughness, int32_t counter, bool active,
+                   uint32_t* id = nullptr) {
+        PipeGeometry pipe{diameter, length, roughness, 0.0f};
+        return this->addCustom(pipe, pipe, counter, active, id);
+    }
+
+    // Entrada e saída com dimensões próprias (maxFlow é resolvido no registro)
+    bool addCustom(const PipeGeometry& in, const PipeGeometry& out, int32_t counter, bool active,
+                   uint32_t* id = nullptr) {
+        uint16_t geometry = 0;
+        if (!this->custom.registerGeometry(in, out, geometry)) return false;
+        uint32_t index = this->custom.add(geometry, counter, active);
+        this->meters.push_back(CUSTOM_MODEL << MODEL_SHIFT | index);
+        if (id) *id = static_cast<uint32_t>(this->meters.size() - 1);
+        return true;
+    }
+
+    void reserve(size_t meterCount) { this->meters.reserve(meterCount); }
+
+    // Carga em massa numa frota vazia: perModel[m] hidrômetros por modelo
+    // (MODEL_COUNT + 1 entradas, a última para o lote de geometrias). Depois,
+    // initMeter pode ser chamado de várias threads para ids distintos.
+    bool prepareBulk(const std::vector<size_t>& perModel) {
+        if (!this->meters.empty() || perModel.size() != MODEL_COUNT + 1) return false;
+        size_t total = 0;
+        for (size_t m = 0; m <= MODEL_COUNT; ++m) {
+            if (perModel[m] > INDEX_MASK) return false;
+            total += perModel[m];
+        }
+        this->meters.resize(total, 0);
+        for (uint32_t m = 0; m < MODEL_COUNT; ++m) {
+            this->visitModels(m, [&](auto& batch) { batch.resize(perModel[m]); });
+        }
+        this->custom.resize(perModel[MODEL_COUNT]);
+        return true;
+    }
+
+    void initMeter(uint32_t id, uint32_t model, uint32_t index, int32_t counter, bool active,
+                   uint16_t geometry = 0) {
+        this->meters[id] = model << MODEL_SHIFT | index;
+        if (model == CUSTOM_MODEL) {
+            this->custom.init(index, geometry, counter, active);
+        } else {
+            this->visitModels(model, [&](auto& batch) { batch.init(index, counter, active); });
+        }
+    }
+
+    template <typename Model>
+    void reserve(size_t meterCount) { std::get<modelIndex<Model>()>(this->batches).reserve(meterCount); }
+
+    bool setFlowRate(uint32_t id, float flow) {
+        const MeterRef ref = this->getRef(id);
+        bool accepted = false;
+        this->visit(ref.model, [&](auto& batch) { accepted = batch.setFlowRate(ref.index, flow); });
+        return accepted;
+    }
+
+    void activate(uint32_t id) { this->setStatus(id, true); }
+    void deactivate(uint32_t id) { this->setStatus(id, false); }
+
+    void setCounter(uint32_t id, int32_t value) {
+        const MeterRef ref = this->getRef(id);
+        this->visit(ref.model, [&](auto& batch) { batch.setCounter(ref.index, value); });
+    }
+
+    // Contador em float (litros), para volume integrado fora do tick
+    void addLiters(uint32_t id, float liters) {
+        const MeterRef ref = this->getRef(id);
+        this->visit(ref.model, [&](auto& batch) { batch.addLiters(ref.index, liters); });
+    }
+
+    float getLiters(uint32_t id) const {
+        const MeterRef ref = this->getRef(id);
+        float liters = 0.0f;
+        this->visit(ref.model, [&](const auto& batch) { liters = batch.getLiters(ref.index); });
+        return liters;
+    }
+
+    // Um passo para todos os lotes; cada lote roda seu kernel especializado
+    void tick(float dt = FLEET_TICK_SECONDS) {
+        std::apply([dt](auto&... batch) { (batch.tick(dt), ...); }, this->batches);
+        this->custom.tick(dt);
+    }
+
+    // Avança apenas um hidrômetro ticks passos (ver ModelBatch::advance)
+    void advance(uint32_t id, uint64_t ticks, float dt = FLEET_TICK_SECONDS) {
+        const MeterRef ref = this->getRef(id);
+        this->visit(ref.model, [&](auto& batch) { batch.advance(ref.index, ticks, dt); });
+    }
+
+    MeterSnapshot getSnapshot(uint32_t id) const {
+        const MeterRef ref = this->getRef(id);
+        MeterSnapshot snap;
+        std::memset(&snap, 0, sizeof(snap));
+        this->visit(ref.model, [&](const auto& batch) { snap = batch.getSnapshot(ref.index); });
+        return snap;
+    }
+
+    // Como ficaria o hidrômetro após advance(id, pending), sem avançá-lo
+    MeterSnapshot getSnapshot(uint32_t id, uint64_t pending, float dt = FLEET_TICK_SECONDS) const {
+        const MeterRef ref = this->getRef(id);
+        MeterSnapshot snap;
+        std::memset(&snap, 0, sizeof(snap));
+        this->visit(ref.model, [&](const auto& batch) { snap = batch.getSnapshot(ref.index, pending, dt); });
+        return snap;
+    }
+
+    MeterRef getRef(uint32_t id) const {
+        uint32_t packed = this->meters[id];
+        return MeterRef{packed >> MODEL_SHIFT, packed & INDEX_MASK};
+    }
+
+    float getMaxFlow(uint32_t id) const {
+        const MeterRef ref = this->getRef(id);
+        return ref.model == CUSTOM_MODEL ? this->custom.getMaxFlow(ref.index) : modelMaxFlow(ref.model);
+    }
+    size_t size() const { return this->meters.size(); }
+
+    // Memória reservada pela frota (lotes + tabela de referências)
+    size_t memoryBytes() const {
+        size_t bytes = this->meters.capacity() * sizeof(uint32_t) + this->custom.memoryBytes();
+        std::apply([&bytes](const auto&... batch) { ((bytes += batch.memoryBytes()), ...); }, this->batches);
+        return bytes;
+    }
+
+    template <typename Model>
+    ModelBatch<Model>& getBatch() { return std::get<modelIndex<Model>()>(this->batches); }
+
+    template <typename Model>
+    const ModelBatch<Model>& getBatch() const { return std::get<modelIndex<Model>()>(this->batches); }
+
+    GeometryBatch& getCustomBatch() { return this->custom; }
+    const GeometryBatch& getCustomBatch() const { return this->custom; }
+
+private:
+    void setStatus(uint32_t id, bool active) {
+        const MeterRef ref = this->getRef(id);
+        this->visit(ref.model, [&](auto& batch) { batch.setStatus(ref.index, active); });
+    }
+
+    // Despacho pelo índice do modelo (fora do laço de tick); visit inclui o
+    // lote de geometrias, visitModels só os lotes dos modelos de compilação
+    template <typename F>
+    void visit(uint32_t model, F&& f) {
+        if (model == CUSTOM_MODEL) f(this->custom);
+        else this->visitImpl(model, f, std::index_sequence_for<Models...>());
+    }
+
+    template <typename F>
+    void visit(uint32_t model, F&& f) const {
+        if (model == CUSTOM_MODEL) f(this->custom);
+        else this->visitImpl(model, f, std::index_sequence_for<Models...>());
+    }
+
+    template <typename F>
+    void visitModels(uint32_t model, F&& f) {
+        this->visitImpl(model, f, std::index_sequence_for<Models...>());
+    }
+
+    template <typename F, size_t... I>
+    void visitImpl(uint32_t model, F& f, std::index_sequence<I...>) {
+        (void)((model == I ? (f(std::get<I>(this->batches)), true) : false) || ...);
+    }
+
+    template <typename F, size_t... I>
+    void visitImpl(uint32_t model, F& f, std::index_sequence<I...>) const {
+        (void)((model == I ? (f(std::get<I>(this->batches)), true) : false) || ...);
+    }
+
+    std::tuple<ModelBatch<Models>...> batches;
+    GeometryBatch custom;
+    std::vector<uint32_t> meters;   // modelo << MODEL_SHIFT | índice no lote
+};
+
+// Lotes dos modelos pré-definidos instanciados em fleet.cpp (compilado com -O3)
+extern template class ModelBatch<Residential15>;
+extern template class ModelBatch<Residential20>;
+extern template class ModelBatch<Commercial50>;
+
+// Frota com os três modelos pré-definidos: 8 bytes de estado + 4 de referência
+using StandardFleet = Fleet<Residential15, Residential20, Commercial50>;
+static_assert(ModelBatch<Residential15>::BYTES_PER_METER + sizeof(uint32_t) <= 12 &&
+              ModelBatch<Residential20>::BYTES_PER_METER + sizeof(uint32_t) <= 12 &&
+              ModelBatch<Commercial50>::BYTES_PER_METER + sizeof(uint32_t) <= 12,
+              "orçamento de 12 bytes por hidrômetro excedido");
+
+#endif // FLEET_H
@@ -0,0 +1,378 @@
+#include "fleet_loader.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <set>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const size_t MODEL_SLOTS = StandardFleet::MODEL_COUNT + 1;   // modelos + lote de geometrias
+const size_t MAX_LOGGED_INVALID = 5;
+
+// Registro interpretado de uma linha (12 bytes)
+struct ParsedMeter {
+    uint32_t fileId;
+    int32_t counter;
+    uint8_t model;
+    uint8_t active;
+    uint16_t geometry;   // índice local do bloco (apenas para geometrias arbitrárias)
+};
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+    bool firstOfFile;
+    std::vector<ParsedMeter> meters;
+    std::vector<std::array<float, 3>> geometries;             // únicas no bloco
+    std::map<std::array<float, 3>, uint16_t> geometryIndex;
+    std::vector<uint16_t> globalGeometry;                      // local -> índice no GeometryBatch
+    size_t perModel[MODEL_SLOTS] = {};
+    size_t invalid = 0;
+    std::vector<std::string> invalidSamples;
+};
+
+struct Field {
+    const char* begin;
+    const char* end;
+};
+
+Field trim(const char* b, const char* e) {
+    while (b < e && (*b == ' ' || *b == '\t')) ++b;
+    while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) --e;
+    return Field{b, e};
+}
+
+bool parseUint32(Field f, uint32_t& out) {
+    if (f.begin == f.end) return false;
+    uint64_t value = 0;
+    for (const char* p = f.begin; p < f.end; ++p) {
+        if (*p < '0' || *p > '9') return false;
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+        if (value > UINT32_MAX) return false;
+    }
+    out = static_cast<uint32_t>(value);
+    return true;
+}
+
+bool parseInt32(Field f, int32_t& out) {
+    bool negative = f.begin < f.end && *f.begin == '-';
+    uint32_t magnitude = 0;
+    if (!parseUint32(Field{f.begin + (negative ? 1 : 0), f.end}, magnitude)) return false;
+    if (magnitude > (negative ? 2147483648u : 2147483647u)) return false;
+    out = negative ? static_cast<int32_t>(-static_cast<int64_t>(magnitude)) : static_cast<int32_t>(magnitude);
+    return true;
+}
+
+bool parseFloat(Field f, float& out) {
+    char buffer[64];
+    size_t length = static_cast<size_t>(f.end - f.begin);
+    if (length == 0 || length >= sizeof(buffer)) return false;
+    std::memcpy(buffer, f.begin, length);
+    buffer[length] = '\0';
+    char* end = nullptr;
+    out = std::strtof(buffer, &end);
+    return end == buffer + length;
+}
+
+// Modelo pelo nome, sem alocar (comparado com StandardFleet::modelName)
+int findModel(Field f) {
+    size_t length = static_cast<size_t>(f.end - f.begin);
+    for (size_t m = 0; m < StandardFleet::MODEL_COUNT; ++m) {
+        const char* name = StandardFleet::modelName(m);
+        if (std::strlen(name) == length && std::memcmp(name, f.begin, length) == 0) return static_cast<int>(m);
+    }
+    return -1;
+}
+
+bool parseGeometry(Field f, std::array<float, 3>& geometry) {
+    const char* p = f.begin;
+    for (int k = 0; k < 3; ++k) {
+        const char* slash = k < 2 ? static_cast<const char*>(std::memchr(p, '/', f.end - p)) : f.end;
+        if (!slash || !parseFloat(trim(p, slash), geometry[k])) return false;
+        p = slash + 1;
+    }
+    return true;
+}
+
+// Interpreta uma linha; false se inválida
+bool parseLine(Chunk& chunk, const char* b, const char* e) {
+    Field fields[4];
+    const char* p = b;
+    for (int k = 0; k < 4; ++k) {
+        const char* comma = k < 3 ? static_cast<const char*>(std::memchr(p, ',', e - p)) : e;
+        if (!comma) return false;
+        fields[k] = trim(p, comma);
+        p = comma + 1;
+    }
+
+    ParsedMeter meter;
+    uint32_t status = 0;
+    if (!parseUint32(fields[0], meter.fileId) || !parseInt32(fields[2], meter.counter) ||
+        !parseUint32(fields[3], status) || status > 1) {
+        return false;
+    }
+    meter.active = static_cast<uint8_t>(status);
+    meter.geometry = 0;
+
+    int model = findModel(fields[1]);
+    if (model >= 0) {
+        meter.model = static_cast<uint8_t>(model);
+    } else {
+        std::array<float, 3> geometry;
+        if (!parseGeometry(fields[1], geometry)) return false;
+        if (!(geometry[0] > 0.0f) || !(geometry[1] > 0.0f) || !(geometry[2] >= 0.0f)) return false;
+        auto it = chunk.geometryIndex.find(geometry);
+        if (it == chunk.geometryIndex.end()) {
+            if (chunk.geometries.size() >= GeometryBatch::MAX_GEOMETRIES) return false;
+            uint16_t local = static_cast<uint16_t>(chunk.geometries.size());
+            chunk.geometries.push_back(geometry);
+            it = chunk.geometryIndex.emplace(geometry, local).first;
+        }
+        meter.model = static_cast<uint8_t>(StandardFleet::CUSTOM_MODEL);
+        meter.geometry = it->second;
+    }
+
+    ++chunk.perModel[meter.model];
+    chunk.meters.push_back(meter);
+    return true;
+}
+
+void parseChunk(Chunk& chunk) {
+    // Estimativa de ~20 bytes por linha para evitar realocações
+    chunk.meters.reserve(static_cast<size_t>(chunk.end - chunk.begin) / 20 + 1);
+
+    const char* p = chunk.begin;
+    bool first = chunk.firstOfFile;
+    while (p < chunk.end) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+        const char* lineEnd = newline ? newline : chunk.end;
+        Field line = trim(p, lineEnd);
+
+        if (line.begin < line.end && *line.begin != '#' && !parseLine(chunk, line.begin, line.end)) {
+            // Cabeçalho na primeira linha do arquivo (id não numérico) é aceito
+            bool header = first && (*line.begin < '0' || *line.begin > '9');
+            if (!header) {
+                ++chunk.invalid;
+                if (chunk.invalidSamples.size() < MAX_LOGGED_INVALID) {
+                    chunk.invalidSamples.emplace_back(line.begin, std::min<size_t>(line.end - line.begin, 80));
+                }
+            }
+        }
+        if (line.begin < line.end) first = false;
+        p = lineEnd + 1;
+    }
+}
+
+// Ids repetidos no arquivo: vale a primeira ocorrência e as demais são
+// descartadas como linhas inválidas. Arquivo em ordem crescente de id (o caso
+// comum) é verificado numa passada; os demais são ordenados por (id, posição)
+void dropDuplicateIds(std::vector<Chunk>& chunks) {
+    bool increasing = true;
+    int64_t previous = -1;
+    for (const Chunk& chunk : chunks) {
+        for (const ParsedMeter& meter : chunk.meters) {
+            if (static_cast<int64_t>(meter.fileId) <= previous) increasing = false;
+            previous = meter.fileId;
+        }
+    }
+    if (increasing) return;
+
+    std::vector<std::array<uint32_t, 3>> order;   // id do arquivo, bloco, índice no bloco
+    for (uint32_t c = 0; c < chunks.size(); ++c) {
+        for (uint32_t i = 0; i < chunks[c].meters.size(); ++i) order.push_back({chunks[c].meters[i].fileId, c, i});
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<std::vector<uint8_t>> duplicate(chunks.size());
+    for (size_t c = 0; c < chunks.size(); ++c) duplicate[c].assign(chunks[c].meters.size(), 0);
+    for (size_t k = 1; k < order.size(); ++k) {
+        if (order[k][0] != order[k - 1][0]) continue;
+        Chunk& chunk = chunks[order[k][1]];
+        duplicate[order[k][1]][order[k][2]] = 1;
+        --chunk.perModel[chunk.meters[order[k][2]].model];
+        ++chunk.invalid;
+        if (chunk.invalidSamples.size() < MAX_LOGGED_INVALID) {
+            chunk.invalidSamples.push_back("id " + std::to_string(order[k][0]) + " repetido");
+        }
+    }
+
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        std::vector<ParsedMeter>& meters = chunks[c].meters;
+        size_t kept = 0;
+        for (size_t i = 0; i < meters.size(); ++i) {
+            if (!duplicate[c][i]) meters[kept++] = meters[i];
+        }
+        meters.resize(kept);
+    }
+}
+
+// Geometrias distintas da frota toda, pelos mesmos bits que
+// GeometryBatch::registerGeometry usa para deduplicar
+size_t countGeometries(const std::vector<Chunk>& chunks) {
+    std::set<std::array<uint32_t, 3>> distinct;
+    for (const Chunk& chunk : chunks) {
+        for (const std::array<float, 3>& geometry : chunk.geometries) {
+            distinct.insert({fleet_detail::bitsFromFlow(geometry[0]), fleet_detail::bitsFromFlow(geometry[1]),
+                             fleet_detail::bitsFromFlow(geometry[2])});
+        }
+    }
+    return distinct.size();
+}
+
+double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+FleetLoader::FleetLoader(unsigned threads) : threads(threads) {}
+
+bool FleetLoader::load(const std::string& path, StandardFleet& fleet, std::vector<uint32_t>& meterIds,
+                       FleetLoadStats* stats) const {
+    auto start = std::chrono::steady_clock::now();
+    FleetLoadStats local;
+    FleetLoadStats& out = stats ? *stats : local;
+    out = FleetLoadStats();
+
+    if (fleet.size() != 0) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] FleetLoader::load - A frota de destino não está vazia");
+        return false;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] FleetLoader::load - Não foi possível abrir " + path + ": " + strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] FleetLoader::load - fstat falhou: " + std::string(strerror(errno)));
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    out.fileBytes = size;
+    const char* data = nullptr;
+    if (size > 0) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            Logger::log(LogLevel::STARTUP, "[ERROR] FleetLoader::load - mmap falhou: " + std::string(strerror(errno)));
+            close(fd);
+            return false;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    close(fd);
+
+    // Blocos de tamanho parecido, cada um terminando numa quebra de linha
+    unsigned threadCount = this->threads ? this->threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t minChunk = 1 << 20;
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, size / minChunk + 1)));
+    out.threads = threadCount;
+
+    std::vector<Chunk> chunks(threadCount);
+    const char* cursor = data;
+    const char* fileEnd = data + size;
+    for (unsigned c = 0; c < threadCount; ++c) {
+        const char* end = c + 1 == threadCount ? fileEnd : std::max(cursor, data + size * (c + 1) / threadCount);
+        if (end < fileEnd) {
+            const char* newline = static_cast<const char*>(std::memchr(end, '\n', fileEnd - end));
+            end = newline ? newline + 1 : fileEnd;
+        }
+        chunks[c].begin = cursor;
+        chunks[c].end = end;
+        chunks[c].firstOfFile = c == 0;
+        cursor = end;
+    }
+
+    auto runParallel = [&](auto&& work) {
+        std::vector<std::thread> workers;
+        for (unsigned c = 1; c < threadCount; ++c) workers.emplace_back(work, c);
+        work(0u);
+        for (std::thread& t : workers) t.join();
+    };
+
+    runParallel([&chunks](unsigned c) { parseChunk(chunks[c]); });
+    if (data) munmap(const_cast<char*>(data), size);
+    dropDuplicateIds(chunks);
+    out.parseMs = millisSince(start);
+    auto buildStart = std::chrono::steady_clock::now();
+
+    // Offsets por bloco: ids da frota e índices nos lotes seguem a ordem do arquivo
+    std::vector<size_t> totals(MODEL_SLOTS, 0);
+    std::vector<std::array<size_t, MODEL_SLOTS>> modelBase(threadCount);
+    std::vector<size_t> idBase(threadCount, 0);
+    size_t meterCount = 0;
+    for (unsigned c = 0; c < threadCount; ++c) {
+        idBase[c] = meterCount;
+        meterCount += chunks[c].meters.size();
+        for (size_t m = 0; m < MODEL_SLOTS; ++m) {
+            modelBase[c][m] = totals[m];
+            totals[m] += chunks[c].perModel[m];
+        }
+        out.invalidLines += chunks[c].invalid;
+        for (const std::string& sample : chunks[c].invalidSamples) {
+            Logger::log(LogLevel::STARTUP, "[ERROR] FleetLoader::load - Linha inválida ignorada: " + sample);
+        }
+    }
+
+    // Limites verificados antes de tocar na frota: uma carga recusada não
+    // deixa geometrias registradas nem lotes redimensionados
+    GeometryBatch& custom = fleet.getCustomBatch();
+    if (custom.geometryCount() + countGeometries(chunks) > GeometryBatch::MAX_GEOMETRIES) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] FleetLoader::load - Limite de geometrias distintas atingido");
+        return false;
+    }
+    if (!fleet.prepareBulk(totals)) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] FleetLoader::load - Frota grande demais para um lote");
+        return false;
+    }
+
+    // Geometrias arbitrárias: registradas (e resolvidas) uma vez para a frota toda
+    uint64_t solvesBefore = custom.getSolveCount();
+    for (Chunk& chunk : chunks) {
+        chunk.globalGeometry.resize(chunk.geometries.size());
+        for (size_t g = 0; g < chunk.geometries.size(); ++g) {
+            // Não falha: geometrias validadas na interpretação e limite verificado acima
+            const std::array<float, 3>& geometry = chunk.geometries[g];
+            custom.registerGeometry(geometry[0], geometry[1], geometry[2], chunk.globalGeometry[g]);
+        }
+    }
+    out.geometrySolves = custom.getSolveCount() - solvesBefore;
+    out.uniqueGeometries = custom.geometryCount();
+
+    meterIds.assign(meterCount, 0);
+
+    runParallel([&](unsigned c) {
+        const Chunk& chunk = chunks[c];
+        std::array<size_t, MODEL_SLOTS> next = modelBase[c];
+        uint32_t id = static_cast<uint32_t>(idBase[c]);
+        for (const ParsedMeter& meter : chunk.meters) {
+            uint16_t geometry = meter.model == StandardFleet::CUSTOM_MODEL ? chunk.globalGeometry[meter.geometry] : 0;
+            fleet.initMeter(id, meter.model, static_cast<uint32_t>(next[meter.model]++), meter.counter,
+                            meter.active != 0, geometry);
+            meterIds[id] = meter.fileId;
+            ++id;
+        }
+    });
+
+    out.meters = meterCount;
+    out.customMeters = totals[StandardFleet::CUSTOM_MODEL];
+    out.perModel = totals;
+    out.buildMs = millisSince(buildStart);
+    out.totalMs = millisSince(start);
+    return true;
+}
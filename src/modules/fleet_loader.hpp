@@ -0,0 +1,57 @@
+#ifndef FLEET_LOADER_H
+#define FLEET_LOADER_H
+
+#include "fleet.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Carga em massa de frotas a partir de um arquivo de definição de hidrômetros.
+//
+// Formato (texto, uma linha por hidrômetro; linhas vazias e iniciadas por '#'
+// são ignoradas, assim como um cabeçalho não numérico na primeira linha):
+//
+//     id,modelo,contador,status
+//     1001,R15,0,1
+//     1002,C50,123456,0
+//     1003,0.025/0.2/0.00005,42,1      <- geometria diâmetro/comprimento/rugosidade (m)
+//
+// O arquivo é mapeado em memória (mmap) e dividido em blocos alinhados a
+// quebras de linha; cada thread interpreta um bloco sem cópias. Modelos
+// conhecidos usam as capacidades resolvidas em compilação; geometrias
+// arbitrárias são deduplicadas e cada uma é resolvida uma única vez. Os lotes
+// da frota são dimensionados de uma vez e preenchidos em paralelo, na ordem
+// do arquivo.
+
+struct FleetLoadStats {
+    size_t meters = 0;
+    size_t invalidLines = 0;
+    size_t customMeters = 0;        // hidrômetros com geometria arbitrária
+    std::vector<size_t> perModel;   // hidrômetros por modelo (MODEL_COUNT + 1, o último é custom)
+    size_t uniqueGeometries = 0;
+    uint64_t geometrySolves = 0;    // soluções de Darcy-Weisbach feitas na carga
+    unsigned threads = 0;
+    size_t fileBytes = 0;
+    double parseMs = 0.0;           // mmap + interpretação paralela
+    double buildMs = 0.0;           // geometrias + preenchimento paralelo dos lotes
+    double totalMs = 0.0;
+};
+
+class FleetLoader {
+public:
+    explicit FleetLoader(unsigned threads = 0);   // 0 = todos os núcleos
+
+    // Carrega path em fleet (que deve estar vazia). meterIds[id na frota] =
+    // id do arquivo. Linhas inválidas (inclusive ids repetidos, depois da
+    // primeira ocorrência) são contadas, registradas no log e ignoradas; false
+    // se o arquivo não puder ser lido, a frota não estiver vazia ou exceder os
+    // limites de lote e de geometrias, casos em que fleet não é alterada.
+    bool load(const std::string& path, StandardFleet& fleet, std::vector<uint32_t>& meterIds,
+              FleetLoadStats* stats = nullptr) const;
+
+private:
+    unsigned threads;
+};
+
+#endif // FLEET_LOADER_H
@@ -0,0 +1,157 @@
+#include "flow_dynamics.hpp"
+#include <algorithm>
+#include <cmath>
+
+FlowDynamics::FlowDynamics(size_t meterCount, const FlowDynamicsConfig& config)
+    : config(config),
+      flow(meterCount, 0.0),
+      target(meterCount, 0.0f),
+      step(meterCount, config.minStep),
+      time(meterCount, 0.0),
+      liters(meterCount, 0.0),
+      slot(meterCount, -1),
+      steps(0),
+      rejected(0) {}
+
+void FlowDynamics::setTarget(uint32_t meter, float target, double now) {
+    this->integrate(meter, now);
+    this->target[meter] = target;
+
+    if (std::fabs(this->flow[meter] - target) > this->config.settleTol) {
+        // Transitório novo começa com passo curto; o controle de erro o alarga
+        this->step[meter] = this->config.minStep;
+        this->markTransient(meter);
+    } else {
+        this->flow[meter] = target;
+        this->markSteady(meter);
+    }
+}
+
+void FlowDynamics::setFlow(uint32_t meter, float flow, double now) {
+    this->integrate(meter, now);
+    this->flow[meter] = flow;
+    this->target[meter] = flow;
+    this->markSteady(meter);
+}
+
+void FlowDynamics::advanceTo(double now) {
+    // De trás para frente: markSteady troca o removido pelo último, já processado
+    for (size_t k = this->transient.size(); k-- > 0;) {
+        this->integrate(this->transient[k], now);
+    }
+}
+
+FlowDynamics::Span FlowDynamics::project(uint32_t meter, double now) const {
+    Span span{this->flow[meter], this->step[meter], this->time[meter], 0.0, 0, 0, this->slot[meter] < 0};
+    if (now <= span.t) return span;
+
+    const double toLiters = 1000.0 * this->config.lossFactor;
+    if (!span.settled) {
+        const double goal = this->target[meter];
+        const double rate = 1.0 / this->config.tau;
+        const double absTol = this->config.absTol;
+        const double minStep = this->config.minStep;
+        const double maxStep = this->config.maxStep;
+        double q = span.q;
+        double h = span.h;
+        double t = span.t;
+
+        while (t < now) {
+            double remaining = now - t;
+            double hh = remaining < h ? remaining : h;
+
+            // Par embutido: Euler (ordem 1) e Heun (ordem 2); a diferença estima o erro local
+            double k1 = (goal - q) * rate;
+            double qEuler = q + hh * k1;
+            double k2 = (goal - qEuler) * rate;
+            double qHeun = q + 0.5 * hh * (k1 + k2);
+            double err = std::fabs(qHeun - qEuler);
+            // Fator de ajuste do passo, comum à rejeição e ao crescimento
+            double scale = err > 0.0 ? 0.9 * std::sqrt(absTol / err) : 5.0;
+
+            if (err > absTol && hh > minStep) {
+                h = std::max(minStep, hh * std::max(0.2, scale));
+                ++span.rejected;
+                continue;
+            }
+
+            span.liters += 0.5 * (q + qHeun) * hh * toLiters;
+            q = qHeun;
+            t += hh;
+            ++span.steps;
+
+            // Só cresce se o passo não foi encurtado para terminar em now
+            if (hh == h) h = std::min(maxStep, h * std::min(5.0, std::max(0.2, scale)));
+
+            if (std::fabs(goal - q) <= this->config.settleTol) {
+                q = goal;
+                span.settled = true;
+                break;
+            }
+        }
+        span.q = q;
+        span.h = h;
+        span.t = t;
+    }
+
+    // Regime permanente: volume em forma fechada, sem passos
+    if (span.settled) {
+        span.liters += span.q * (now - span.t) * toLiters;
+        span.t = now;
+    }
+    return span;
+}
+
+void FlowDynamics::integrate(uint32_t meter, double now) {
+    if (now <= this->time[meter]) return;
+    const bool transient = this->slot[meter] >= 0;
+    Span span = this->project(meter, now);
+    this->flow[meter] = span.q;
+    this->time[meter] = span.t;
+    this->liters[meter] += span.liters;
+    this->steps += span.steps;
+    this->rejected += span.rejected;
+    if (!transient) return;
+    this->step[meter] = static_cast<float>(span.h);
+    if (span.settled) this->markSteady(meter);
+}
+
+void FlowDynamics::markTransient(uint32_t meter) {
+    if (this->slot[meter] >= 0) return;
+    this->slot[meter] = static_cast<int32_t>(this->transient.size());
+    this->transient.push_back(meter);
+}
+
+void FlowDynamics::markSteady(uint32_t meter) {
+    int32_t s = this->slot[meter];
+    if (s < 0) return;
+    uint32_t last = this->transient.back();
+    this->transient[s] = last;
+    this->slot[last] = s;
+    this->transient.pop_back();
+    this->slot[meter] = -1;
+}
+
+float FlowDynamics::getFlow(uint32_t meter) const { return static_cast<float>(this->flow[meter]); }
+float FlowDynamics::getTarget(uint32_t meter) const { return this->target[meter]; }
+bool FlowDynamics::isSteady(uint32_t meter) const { return this->slot[meter] < 0; }
+
+float FlowDynamics::getFlow(uint32_t meter, double now) const {
+    return static_cast<float>(this->project(meter, now).q);
+}
+
+double FlowDynamics::getLiters(uint32_t meter, double now) const {
+    return this->liters[meter] + this->project(meter, now).liters;
+}
+
+double FlowDynamics::takeLiters(uint32_t meter, double now) {
+    this->integrate(meter, now);
+    double taken = this->liters[meter];
+    this->liters[meter] = 0.0;
+    return taken;
+}
+
+size_t FlowDynamics::size() const { return this->flow.size(); }
+size_t FlowDynamics::getTransientCount() const { return this->transient.size(); }
+uint64_t FlowDynamics::getStepCount() const { return this->steps; }
+uint64_t FlowDynamics::getRejectedCount() const { return this->rejected; }
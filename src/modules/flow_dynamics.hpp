@@ -0,0 +1,94 @@
+#ifndef FLOW_DYNAMICS_H
+#define FLOW_DYNAMICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Vazão com inércia: cada hidrômetro tende à vazão-alvo (definida por
+// abertura de válvula ou pressão de alimentação) segundo uma dinâmica de
+// primeira ordem, dq/dt = (alvo - q) / tau, em vez do degrau instantâneo de
+// Pipe::setFlowRate.
+//
+// A integração é por hidrômetro e com passo adaptativo (par embutido
+// Heun/Euler com controle de erro): passos curtos no início do transitório,
+// passos crescentes à medida que a vazão se acomoda. Quando |q - alvo| fica
+// abaixo de settleTol o hidrômetro entra em regime permanente e sai da lista
+// de ativos; a partir daí nenhum passo é dado e o volume é calculado em forma
+// fechada (q * tempo) apenas quando lido ou quando o alvo muda.
+//
+// Na frota em lote é ligada por FleetBehaviorTarget::enableFlowDynamics
+// (simulator --behaviors N --flow-tau S), que transfere o volume dos
+// transitórios ao contador da frota com takeLiters. Hidrometer e Pipe::setFlowRate
+// continuam com o degrau: são a referência do verificador de equivalência.
+
+struct FlowDynamicsConfig {
+    float tau = 2.0f;           // constante de tempo (s): inércia da coluna d'água + válvula
+    float absTol = 1e-6f;       // erro local máximo por passo (m³/s)
+    float settleTol = 1e-8f;    // distância ao alvo para regime permanente (m³/s)
+    float minStep = 1e-3f;      // passo mínimo (s)
+    float maxStep = 2.0f;       // passo máximo durante transitórios (s)
+    float lossFactor = 0.9f;    // OUT = IN * 0.9, como em Hidrometer::update
+};
+
+class FlowDynamics {
+public:
+    explicit FlowDynamics(size_t meterCount, const FlowDynamicsConfig& config = FlowDynamicsConfig());
+
+    // Nova vazão-alvo (m³/s) a partir do instante now (s). O hidrômetro é
+    // integrado até now com o alvo anterior antes da troca.
+    void setTarget(uint32_t meter, float target, double now);
+
+    // Vazão atual e alvo de uma vez, sem transitório (ex.: estado inicial)
+    void setFlow(uint32_t meter, float flow, double now);
+
+    // Integra todos os hidrômetros em transitório até now
+    void advanceTo(double now);
+
+    float getFlow(uint32_t meter) const;      // vazão IN no último instante integrado
+    float getTarget(uint32_t meter) const;
+    bool isSteady(uint32_t meter) const;
+
+    // Vazão IN e volume medido (vazão OUT, litros) em now, sem avançar o
+    // estado: um hidrômetro em transitório é integrado numa cópia
+    float getFlow(uint32_t meter, double now) const;
+    double getLiters(uint32_t meter, double now) const;
+    // Integra até now e devolve o volume acumulado, zerando-o (para
+    // transferi-lo a outro contador)
+    double takeLiters(uint32_t meter, double now);
+
+    size_t size() const;
+    size_t getTransientCount() const;
+    uint64_t getStepCount() const;      // passos aceitos desde a criação
+    uint64_t getRejectedCount() const;  // passos rejeitados pelo controle de erro
+
+private:
+    // Resultado de integrar um hidrômetro do seu instante até now
+    struct Span {
+        double q;
+        double h;          // passo para o próximo avanço
+        double t;
+        double liters;     // volume no intervalo
+        uint64_t steps;
+        uint64_t rejected;
+        bool settled;      // em regime permanente ao final
+    };
+
+    Span project(uint32_t meter, double now) const;
+    void integrate(uint32_t meter, double now);
+    void markTransient(uint32_t meter);
+    void markSteady(uint32_t meter);
+
+    FlowDynamicsConfig config;
+    std::vector<double> flow;      // em double para convergir ao alvo sem ficar a 1 ulp
+    std::vector<float> target;
+    std::vector<float> step;       // último passo aceito (s), reaproveitado no próximo avanço
+    std::vector<double> time;      // instante até onde o hidrômetro foi integrado (s)
+    std::vector<double> liters;    // volume acumulado até time (L)
+    std::vector<int32_t> slot;     // posição em transient, -1 em regime permanente
+    std::vector<uint32_t> transient;
+    uint64_t steps;
+    uint64_t rejected;
+};
+
+#endif // FLOW_DYNAMICS_H
@@ -0,0 +1,265 @@
+#include "head_end.hpp"
+#include "../utils/logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+const int MAX_CLIENTS = 1024;
+const size_t RECV_BYTES = 256u << 10;
+
+struct Client {
+    int fd;
+    std::string input;
+    size_t consumed;       // bytes de input já processados
+    std::string output;    // confirmações pendentes
+    size_t sent;
+};
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Envia o que couber sem bloquear; false se a conexão caiu
+bool flush(Client& client) {
+    while (client.sent < client.output.size()) {
+        ssize_t n = send(client.fd, client.output.data() + client.sent, client.output.size() - client.sent, MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        client.sent += static_cast<size_t>(n);
+    }
+    client.output.clear();
+    client.sent = 0;
+    return true;
+}
+
+} // namespace
+
+void ReadingBatchEncoder::begin(uint32_t sequence, uint32_t route, uint32_t cycle, uint64_t snapshotEpoch, uint16_t flags) {
+    this->header = ReadingBatchHeader{READING_BATCH_MAGIC, READING_BATCH_VERSION, flags, sequence, route, cycle, 0,
+                                      snapshotEpoch, 0, 0};
+    this->buffer.assign(sizeof(ReadingBatchHeader), '\0');
+    this->previous = 0;
+}
+
+void ReadingBatchEncoder::add(uint32_t meter, int32_t counter, bool active) {
+    if (this->header.count == 0) {
+        this->header.baseId = meter;
+        this->previous = meter;
+    }
+    putVarint(this->buffer, static_cast<uint64_t>(meter - this->previous) << 1 | (active ? 1u : 0u));
+    putVarint(this->buffer, static_cast<uint32_t>(counter));
+    this->previous = meter;
+    ++this->header.count;
+}
+
+const std::string& ReadingBatchEncoder::finish() {
+    this->header.payloadBytes = static_cast<uint32_t>(this->buffer.size() - sizeof(ReadingBatchHeader));
+    std::memcpy(&this->buffer[0], &this->header, sizeof(this->header));
+    return this->buffer;
+}
+
+uint32_t ReadingBatchEncoder::count() const { return this->header.count; }
+uint32_t ReadingBatchEncoder::getSequence() const { return this->header.sequence; }
+
+bool decodeReadingBatch(const ReadingBatchHeader& header, const uint8_t* payload, uint64_t& checksum) {
+    const uint8_t* p = payload;
+    const uint8_t* end = payload + header.payloadBytes;
+    uint64_t meter = header.baseId;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < header.count; ++i) {
+        uint64_t idField = 0, counter = 0;
+        if (!getVarint(p, end, idField) || !getVarint(p, end, counter)) return false;
+        meter += idField >> 1;
+        if (meter > UINT32_MAX || counter > UINT32_MAX) return false;
+        sum += readingChecksum(static_cast<uint32_t>(meter), static_cast<int32_t>(counter), idField & 1);
+    }
+    if (p != end) return false;
+    checksum += sum;
+    return true;
+}
+
+HeadEndServer::HeadEndServer() : listenFd(-1) {}
+
+HeadEndServer::~HeadEndServer() {
+    this->stop();
+}
+
+bool HeadEndServer::start(const std::string& path) {
+    if (this->listenFd >= 0) return false;
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] HeadEndServer::start - Caminho do socket longo demais: " + path);
+        return false;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] HeadEndServer::start - socket falhou: " + std::string(strerror(errno)));
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 64) != 0 ||
+        !setNonBlocking(fd)) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] HeadEndServer::start - Não foi possível escutar em " + path + ": " + strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    this->path = path;
+    this->listenFd = fd;
+    this->serverThread = std::thread(&HeadEndServer::serveLoop, this);
+    return true;
+}
+
+void HeadEndServer::stop() {
+    if (this->listenFd < 0) return;
+    this->stopSignal.requestStop();
+    if (this->serverThread.joinable()) this->serverThread.join();
+    close(this->listenFd);
+    unlink(this->path.c_str());
+    this->listenFd = -1;
+}
+
+HeadEndStats HeadEndServer::getStats() const {
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    return this->stats;
+}
+
+void HeadEndServer::serveLoop() {
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+    std::vector<char> buffer(RECV_BYTES);
+
+    while (!this->stopSignal.stopRequested()) {
+        fds.clear();
+        fds.push_back(pollfd{this->stopSignal.fd(), POLLIN, 0});
+        fds.push_back(pollfd{this->listenFd, POLLIN, 0});
+        for (const Client& client : clients) {
+            fds.push_back(pollfd{client.fd, static_cast<short>(POLLIN | (client.output.empty() ? 0 : POLLOUT)), 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            Logger::log(LogLevel::RUNTIME, "[ERROR] HeadEndServer::serveLoop - poll falhou: " + std::string(strerror(errno)));
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd;
+            while ((fd = accept4(this->listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                if (clients.size() >= static_cast<size_t>(MAX_CLIENTS)) {
+                    close(fd);
+                    continue;
+                }
+                clients.push_back(Client{fd, std::string(), 0, std::string(), 0});
+                // Sem eventos nesta passada; mantém fds[c + 2] pareado com clients[c]
+                fds.push_back(pollfd{fd, 0, 0});
+                std::lock_guard<std::mutex> lock(this->statsMutex);
+                ++this->stats.connections;
+            }
+        }
+
+        for (size_t c = 0; c < clients.size(); ++c) {
+            Client& client = clients[c];
+            short revents = fds[c + 2].revents;
+            bool alive = !(revents & (POLLERR | POLLNVAL));
+
+            if (alive && (revents & (POLLIN | POLLHUP))) {
+                ssize_t n = recv(client.fd, buffer.data(), buffer.size(), 0);
+                if (n > 0) {
+                    client.input.append(buffer.data(), static_cast<size_t>(n));
+                } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    alive = false;
+                }
+            }
+
+            // Processa os lotes completos e acumula as confirmações
+            HeadEndStats delta;
+            while (alive && client.input.size() - client.consumed >= sizeof(ReadingBatchHeader)) {
+                ReadingBatchHeader header;
+                std::memcpy(&header, client.input.data() + client.consumed, sizeof(header));
+                if (header.magic != READING_BATCH_MAGIC || header.version != READING_BATCH_VERSION ||
+                    header.payloadBytes > READING_BATCH_MAX_PAYLOAD) {
+                    ++delta.malformed;
+                    alive = false;   // sem enquadramento confiável: encerra a conexão
+                    break;
+                }
+                size_t total = sizeof(header) + header.payloadBytes;
+                if (client.input.size() - client.consumed < total) break;
+
+                const uint8_t* payload = reinterpret_cast<const uint8_t*>(client.input.data() + client.consumed + sizeof(header));
+                uint64_t checksum = 0;
+                bool valid = decodeReadingBatch(header, payload, checksum);
+                ReadingAck ack{READING_ACK_MAGIC, header.sequence, valid ? header.count : 0u, valid ? 0u : 1u};
+                client.output.append(reinterpret_cast<const char*>(&ack), sizeof(ack));
+                client.consumed += total;
+
+                ++delta.batches;
+                delta.bytes += total;
+                if (valid) {
+                    delta.readings += header.count;
+                    delta.checksum += checksum;
+                    if (header.flags & READING_BATCH_RETRY) ++delta.retryBatches;
+                } else {
+                    ++delta.malformed;
+                }
+            }
+            if (client.consumed > 0 && client.consumed == client.input.size()) {
+                client.input.clear();
+                client.consumed = 0;
+            } else if (client.consumed > RECV_BYTES) {
+                client.input.erase(0, client.consumed);
+                client.consumed = 0;
+            }
+            if (delta.batches > 0 || delta.malformed > 0) {
+                std::lock_guard<std::mutex> lock(this->statsMutex);
+                this->stats.batches += delta.batches;
+                this->stats.retryBatches += delta.retryBatches;
+                this->stats.readings += delta.readings;
+                this->stats.bytes += delta.bytes;
+                this->stats.malformed += delta.malformed;
+                this->stats.checksum += delta.checksum;
+            }
+
+            if (alive && !client.output.empty()) alive = flush(client);
+
+            if (!alive) {
+                close(client.fd);
+                clients[c] = std::move(clients.back());
+                clients.pop_back();
+                fds[c + 2] = fds.back();
+                fds.pop_back();
+                --c;
+            }
+        }
+    }
+
+    for (Client& client : clients) close(client.fd);
+}
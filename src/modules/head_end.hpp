@@ -0,0 +1,126 @@
+#ifndef HEAD_END_H
+#define HEAD_END_H
+
+#include "../utils/stop_signal.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Substituto local do head-end de leitura: recebe lotes binários de leituras
+// por um socket Unix de stream e confirma cada um.
+//
+// Lote versão 1 (little-endian, offsets em bytes):
+//
+//   Cabeçalho (40 bytes)
+//     +0   uint32  magic          0x42445248 ("HRDB")
+//     +4   uint16  version        1
+//     +6   uint16  flags          bit 0: nova tentativa de hidrômetros sem resposta
+//     +8   uint32  sequence       sequência do lote na conexão
+//     +12  uint32  route          rota de leitura
+//     +16  uint32  cycle          ciclo da rota
+//     +20  uint32  count          leituras no lote
+//     +24  uint64  snapshotEpoch  snapshot de onde as leituras vieram
+//     +32  uint32  baseId         id da primeira leitura
+//     +36  uint32  payloadBytes   bytes de payload após o cabeçalho
+//
+//   Payload: count leituras em ordem crescente de id, cada uma com dois
+//   varints LEB128: ((id - idAnterior) << 1 | ativo), começando em baseId, e
+//   o contador em litros. Em uma rota contígua a leitura ocupa ~4 bytes.
+//
+//   Confirmação (16 bytes, uma por lote, na ordem de envio)
+//     +0   uint32  magic          0x4B434148 ("HACK")
+//     +4   uint32  sequence       sequência do lote confirmado
+//     +8   uint32  accepted       leituras aceitas
+//     +12  uint32  status         0 = aceito, 1 = malformado
+
+#define HEAD_END_DEFAULT_PATH "/tmp/hydrometer_headend.sock"
+#define READING_BATCH_MAGIC 0x42445248u
+#define READING_ACK_MAGIC 0x4B434148u
+#define READING_BATCH_VERSION 1
+#define READING_BATCH_RETRY 0x1
+#define READING_BATCH_MAX_PAYLOAD (16u << 20)
+
+struct ReadingBatchHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t sequence;
+    uint32_t route;
+    uint32_t cycle;
+    uint32_t count;
+    uint64_t snapshotEpoch;
+    uint32_t baseId;
+    uint32_t payloadBytes;
+};
+
+struct ReadingAck {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t accepted;
+    uint32_t status;
+};
+
+static_assert(sizeof(ReadingBatchHeader) == 40, "layout do lote mudou");
+static_assert(sizeof(ReadingAck) == 16, "layout da confirmação mudou");
+
+// Soma de verificação das leituras entregues (mesma conta nos dois lados)
+inline uint64_t readingChecksum(uint32_t meter, int32_t counter, bool active) {
+    return (static_cast<uint64_t>(meter) * 0x9E3779B97F4A7C15ull) ^
+           (static_cast<uint64_t>(static_cast<uint32_t>(counter)) << 1 | (active ? 1u : 0u));
+}
+
+// Monta um lote no buffer (cabeçalho + payload) sem alocar entre lotes
+class ReadingBatchEncoder {
+public:
+    void begin(uint32_t sequence, uint32_t route, uint32_t cycle, uint64_t snapshotEpoch, uint16_t flags);
+    void add(uint32_t meter, int32_t counter, bool active);   // ids crescentes
+    const std::string& finish();
+
+    uint32_t count() const;
+    uint32_t getSequence() const;
+
+private:
+    std::string buffer;
+    ReadingBatchHeader header;
+    uint32_t previous = 0;
+};
+
+// Percorre o payload; false se estiver malformado (count, tamanho ou ids)
+bool decodeReadingBatch(const ReadingBatchHeader& header, const uint8_t* payload, uint64_t& checksum);
+
+struct HeadEndStats {
+    uint64_t batches = 0;
+    uint64_t retryBatches = 0;
+    uint64_t readings = 0;
+    uint64_t bytes = 0;
+    uint64_t malformed = 0;
+    uint64_t connections = 0;
+    uint64_t checksum = 0;         // soma de readingChecksum das leituras aceitas
+};
+
+class HeadEndServer {
+public:
+    HeadEndServer();
+    ~HeadEndServer();
+
+    // Cria o socket em path e atende em uma thread própria
+    bool start(const std::string& path = HEAD_END_DEFAULT_PATH);
+    void stop();
+
+    HeadEndStats getStats() const;
+
+private:
+    void serveLoop();
+
+    std::string path;
+    int listenFd;
+    StopSignal stopSignal;
+    std::thread serverThread;
+    HeadEndStats stats;
+    mutable std::mutex statsMutex;
+};
+
+#endif // HEAD_END_H
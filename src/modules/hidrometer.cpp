@@ -1,25 +1,43 @@
 #include "hidrometer.hpp"
 #include "../utils/logger.hpp"
+#include "../utils/cpu_affinity.hpp"
 #include <iostream>
 #include <iomanip>
 
+Hidrometer::Hidrometer() : Hidrometer(Residential15::GEOMETRY) {}
+
+Hidrometer::Hidrometer(const MeterGeometry& geometry)
+    : Hidrometer(std::make_unique<Pipe>(geometry.in.diameter, geometry.in.length, geometry.in.roughness, geometry.in.maxFlow),
+                 std::make_unique<Pipe>(geometry.out.diameter, geometry.out.length, geometry.out.roughness, geometry.out.maxFlow))
+{
+}
+
 Hidrometer::Hidrometer(float diameterIN,
            float lengthIN,
            float roughnessIN,
            float diameterOUT,
            float lengthOUT,
            float roughnessOUT)
-    : pipeIN(std::make_unique<Pipe>(diameterIN, lengthIN, roughnessIN)),
-      pipeOUT(std::make_unique<Pipe>(diameterOUT, lengthOUT, roughnessOUT))
+    : Hidrometer(std::make_unique<Pipe>(diameterIN, lengthIN, roughnessIN),
+                 std::make_unique<Pipe>(diameterOUT, lengthOUT, roughnessOUT))
+{
+}
+
+Hidrometer::Hidrometer(std::unique_ptr<Pipe> pipeIN, std::unique_ptr<Pipe> pipeOUT)
+    : pipeIN(std::move(pipeIN)),
+      pipeOUT(std::move(pipeOUT)),
+      clock(std::chrono::milliseconds(100))
 {
     Logger::log(LogLevel::DEBUG, "[DEBUG] Hidrometer::Constructor - Iniciando construção do hidrómetro");
-    Logger::log(LogLevel::DEBUG, "[DEBUG] Hidrometer::Constructor - Pipe IN: D=" + std::to_string(diameterIN) + "m, L=" + std::to_string(lengthIN) + "m, R=" + std::to_string(roughnessIN) + "m");
-    Logger::log(LogLevel::DEBUG, "[DEBUG] Hidrometer::Constructor - Pipe OUT: D=" + std::to_string(diameterOUT) + "m, L=" + std::to_string(lengthOUT) + "m, R=" + std::to_string(roughnessOUT) + "m");
+    Logger::log(LogLevel::DEBUG, "[DEBUG] Hidrometer::Constructor - Pipe IN: D=" + std::to_string(this->pipeIN->getDiameter()) + "m, L=" + std::to_string(this->pipeIN->getLength()) + "m, R=" + std::to_string(this->pipeIN->getRoughness()) + "m");
+    Logger::log(LogLevel::DEBUG, "[DEBUG] Hidrometer::Constructor - Pipe OUT: D=" + std::to_string(this->pipeOUT->getDiameter()) + "m, L=" + std::to_string(this->pipeOUT->getLength()) + "m, R=" + std::to_string(this->pipeOUT->getRoughness()) + "m");
 
     this->status.store(false);
     this->counter.store(0);
     this->counterFloat = 0.0f;
-    this->running.store(true);
+    this->sharedSlot.store(nullptr);
+    this->sharedId = 0;
+    this->publishedTicks = 0;
     
     Logger::log(LogLevel::DEBUG, "[DEBUG] Hidrometer::Constructor - Status inicial: Inactive");
     Logger::log(LogLevel::DEBUG, "[DEBUG] Hidrometer::Constructor - Contador inicial: 0");
@@ -27,9 +45,18 @@ Hidrometer::Hidrometer(float diameterIN,
     
     this->update_thread = std::thread([this]() {
         Logger::log(LogLevel::DEBUG, "[DEBUG] Hidrometer::UpdateThread - Thread de atualização iniciada");
-        while (running.load()) {
-            this->update();
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Prazos absolutos a cada 100ms e integração com o dt medido: o tempo de
+        // trabalho e o atraso do escalonador não fazem o contador derivar
+        this->clock.start();
+        this->update(0.0f);
+        for (;;) {
+            // Mudanças de controle são publicadas na hora; a parada interrompe a espera
+            StopSignal::Wake wake;
+            while ((wake = this->control.waitUntil(this->clock.deadline())) == StopSignal::Wake::NOTIFIED) {
+                this->refresh();
+            }
+            if (wake == StopSignal::Wake::STOPPED) break;
+            this->update(static_cast<float>(this->clock.tick()));
         }
         Logger::log(LogLevel::SHUTDOWN, "[DEBUG] Hidrometer::UpdateThread - Thread de atualização finalizada");
     });
@@ -39,7 +66,7 @@ Hidrometer::Hidrometer(float diameterIN,
 
 Hidrometer::~Hidrometer() {
     Logger::log(LogLevel::SHUTDOWN, "[DEBUG] Hidrometer::Destructor - Finalizando hidrómetro...");
-    running.store(false);
+    this->control.requestStop();
     
     if (update_thread.joinable()) {
         update_thread.join();
@@ -51,22 +78,34 @@ Pipe* Hidrometer::getPipeIN() const { return this->pipeIN.get(); }
 Pipe* Hidrometer::getPipeOUT() const { return this->pipeOUT.get(); }
 int Hidrometer::getCounter() const { return this->counter.load(); }
 bool Hidrometer::getStatus() const { return this->status.load(); }
+MeterSnapshot Hidrometer::getSnapshot(uint32_t* version) const { return this->snapshot.load(version); }
 
 void Hidrometer::activate() { 
     Logger::log(LogLevel::STARTUP, "[DEBUG] Hidrometer::activate - Ativando hidrómetro");
-    this->status.store(true);
+    this->setStatus(true);
     Logger::log(LogLevel::STARTUP, "[DEBUG] Hidrometer::activate - Status atual: Active");
 }
 
 void Hidrometer::deactivate() { 
     Logger::log(LogLevel::SHUTDOWN, "[DEBUG] Hidrometer::deactivate - Desativando hidrómetro");
+    this->setStatus(false);
+}
+
+void Hidrometer::setStatus(bool active) {
+    this->status.store(active);
+    this->control.notify();
+}
+
+void Hidrometer::requestShutdown() {
     this->status.store(false);
+    this->control.requestStop();
 }
 
+void Hidrometer::notifyControl() { this->control.notify(); }
+
 void Hidrometer::shutdown() {
     Logger::log(LogLevel::SHUTDOWN, "[DEBUG] Hidrometer::shutdown - Parando thread do hidrómetro");
-    this->status.store(false);
-    this->running.store(false);
+    this->requestShutdown();
     
     if (this->update_thread.joinable()) {
         this->update_thread.join();
@@ -79,24 +118,73 @@ void Hidrometer::setCounter(int valor) {
     this->counterFloat = static_cast<float>(valor);
 }
 
+void Hidrometer::attachSharedSlot(SharedMeterSlot* slot, uint32_t id) {
+    // O id é gravado antes do ponteiro; a thread de atualização só o lê após ver o slot
+    this->sharedId = id;
+    this->sharedSlot.store(slot, std::memory_order_release);
+}
+
+void Hidrometer::publish(bool active, float flowIN) {
+    // Campos capturados no mesmo tick: status e vazão IN usados no cálculo,
+    // vazão OUT e contador recém-gravados por esta mesma thread
+    MeterSnapshot current;
+    current.status = active ? 1u : 0u;
+    current.flowIN = flowIN;
+    current.flowOUT = this->pipeOUT->getFlowRate();
+    current.counter = this->counter.load();
+    current.ticks = ++this->publishedTicks;
+    this->snapshot.store(current);
+
+    SharedMeterSlot* slot = this->sharedSlot.load(std::memory_order_acquire);
+    if (!slot) return;
+
+    SharedMeterRecord record;
+    record.id = this->sharedId;
+    record.status = current.status;
+    record.flowIN = current.flowIN;
+    record.flowOUT = current.flowOUT;
+    record.counter = current.counter;
+    record.maxFlow = this->pipeIN->getMaxFlow();
+    record.ticks = current.ticks;
+    slot->record.store(record);
+}
+
+// Reflete status e vazão IN atuais no snapshot sem avançar o contador
+void Hidrometer::refresh() {
+    bool active = this->status.load();
+    float flowIN = this->pipeIN->getFlowRate();
+    this->pipeOUT->setFlowRate(active ? flowIN * 0.9f : 0.0f);
+    this->publish(active, flowIN);
+}
+
 void Hidrometer::update() {
-    static int updateCount = 0;
-    updateCount++;
-            
-    if (this->status.load()) {
-        float flowIN = this->pipeIN->getFlowRate();
+    this->update(0.1f);
+}
+
+TickHistogram Hidrometer::getTickHistogram() const { return this->clock.getHistogram(); }
+
+bool Hidrometer::pinTo(const std::vector<int>& cpus) { return pinThread(this->update_thread, cpus); }
+
+void Hidrometer::update(float dt) {
+    // Lidos uma única vez para que o snapshot reflita exatamente o que foi integrado
+    bool active = this->status.load();
+    float flowIN = this->pipeIN->getFlowRate();
+
+    if (active) {
         float flowOUT = flowIN * 0.9f; // simula perda de 10%
         this->pipeOUT->setFlowRate(flowOUT);
 
         // Incrementa contador de forma mais realista
-        // Intervalo de atualização: 0.1s
-        // Conversão: m³/s * 0.1s = m³ por intervalo
+        // Intervalo de atualização: dt (0.1s nominal, medido pela thread interna)
+        // Conversão: m³/s * dt = m³ por intervalo
         // Depois convertemos para litros: m³ * 1000 = L
-        float volumeIncrement = flowOUT * 0.1f; // m³ por intervalo de 0.1s
+        float volumeIncrement = flowOUT * dt; // m³ no intervalo
         this->counterFloat += volumeIncrement * 1000.0f; // Converte m³ para litros
         this->counter.store(static_cast<int>(this->counterFloat));
                     
     } else {
         this->pipeOUT->setFlowRate(0.0f);
     }
+
+    this->publish(active, flowIN);
 }
@@ -2,10 +2,15 @@
 #define HIDROMETER_H
 
 #include "pipe.hpp"
+#include "meter_model.hpp"
+#include "shared_fleet.hpp"
+#include "../utils/stop_signal.hpp"
+#include "../utils/tick_clock.hpp"
 #include <thread>
 #include <chrono>
 #include <memory>
 #include <atomic>
+#include <vector>
 
 #define DIAMETER_IN 0.015f
 #define LENGTH_IN 0.15f
@@ -14,10 +19,23 @@
 #define LENGTH_OUT 0.15f
 #define ROUGHNESS_OUT 0.00005f
 
+// Leitura consistente dos quatro campos de um hidrômetro no mesmo tick
+struct MeterSnapshot {
+    uint32_t status;   // 1 = ativo
+    float flowIN;      // m³/s
+    float flowOUT;     // m³/s
+    int32_t counter;   // litros
+    uint32_t ticks;    // atualizações publicadas
+};
+
 class Hidrometer {
     public:
-        Hidrometer(float diameterIN = DIAMETER_IN, float lengthIN = LENGTH_IN, float roughnessIN = ROUGHNESS_IN,
-                float diameterOUT = DIAMETER_OUT, float lengthOUT = LENGTH_OUT, float roughnessOUT = ROUGHNESS_OUT);
+        // Modelo padrão (Residential15): vazões máximas já resolvidas em compilação
+        Hidrometer();
+        explicit Hidrometer(const MeterGeometry& geometry);
+        // Geometria arbitrária: resolve Darcy-Weisbach em tempo de execução
+        Hidrometer(float diameterIN, float lengthIN, float roughnessIN,
+                float diameterOUT, float lengthOUT, float roughnessOUT);
 
         ~Hidrometer();
 
@@ -26,23 +44,60 @@ class Hidrometer {
         int getCounter() const;
         bool getStatus() const;
 
+        // Snapshot versionado (seqlock) publicado a cada update: leitores não
+        // usam locks e a thread de atualização nunca espera por eles
+        MeterSnapshot getSnapshot(uint32_t* version = nullptr) const;
+
         void activate();
         void deactivate();
+        // Mesmo efeito de activate/deactivate, sem registrar no Logger
+        // (manobras em massa, ex.: verificação de equivalência)
+        void setStatus(bool active);
         void shutdown();  // Para completamente o hidrômetro (finaliza thread)
+        // Pede a parada sem aguardar a thread: permite parar uma frota inteira
+        // em paralelo e depois chamar shutdown() em cada hidrômetro
+        void requestShutdown();
+        // Acorda a thread para publicar status/vazão alterados sem esperar o
+        // próximo update (o contador não é integrado fora do período)
+        void notifyControl();
         void setCounter(int valor);  // Restaura contador (para persistência)
 
-    private:
+        // Publica o estado a cada update no slot de memória compartilhada (nullptr desliga)
+        void attachSharedSlot(SharedMeterSlot* slot, uint32_t id);
+
+        // Um passo de integração (0.1s). Público para permitir benchmarks
+        // com a thread interna parada (ver shutdown()).
         void update();
+        // Passo de integração com o intervalo real decorrido (s), usado pela
+        // thread interna a cada tick do relógio de prazos absolutos
+        void update(float dt);
+
+        // Atraso dos ticks da thread interna em relação aos prazos
+        TickHistogram getTickHistogram() const;
+        // Fixa a thread de atualização nas CPUs dadas
+        bool pinTo(const std::vector<int>& cpus);
+
+    private:
+        Hidrometer(std::unique_ptr<Pipe> pipeIN, std::unique_ptr<Pipe> pipeOUT);
+        void publish(bool active, float flowIN);
+        void refresh();
 
         std::unique_ptr<Pipe> pipeIN;
         std::unique_ptr<Pipe> pipeOUT;
         std::thread update_thread;
-        std::atomic<bool> running;
+        StopSignal control;
+        TickClock clock;
         std::atomic<int> counter;
         std::atomic<bool> status;
         
         // Contador interno com maior precisão
         float counterFloat;
+
+        // Snapshot e memória compartilhada (escritos apenas pela thread de atualização)
+        SeqLock<MeterSnapshot> snapshot;
+        std::atomic<SharedMeterSlot*> sharedSlot;
+        uint32_t sharedId;
+        uint32_t publishedTicks;
     };
 
 #endif // HIDROMETER_H
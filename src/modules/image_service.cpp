@@ -0,0 +1,285 @@
+#include "image_service.hpp"
+#include "../utils/logger.hpp"
+#include "../utils/cpu_affinity.hpp"
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const size_t MAX_REQUEST_BYTES = 256;
+const int MAX_CLIENTS = 1024;
+
+struct Client {
+    int fd;
+    std::string input;
+    std::string header;     // "OK <bytes>\n" ou "ERR ...\n"
+    Frame frame;            // PNG em envio (compartilhado com o cache)
+    size_t sent;            // bytes já enviados de header + frame
+
+    size_t pending() const { return this->header.size() + (this->frame ? this->frame->size() : 0) - this->sent; }
+};
+
+int32_t floorDiv(int32_t value, int32_t step) {
+    int32_t q = value / step;
+    return (value % step != 0 && value < 0) ? q - 1 : q;
+}
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Interpreta "GET <id>"; false se a linha é inválida
+bool parseRequest(const std::string& line, uint32_t& meter) {
+    if (line.compare(0, 4, "GET ") != 0 || line.size() == 4) return false;
+    char* end = nullptr;
+    unsigned long value = std::strtoul(line.c_str() + 4, &end, 10);
+    if (*end != '\0' || value > UINT32_MAX) return false;
+    meter = static_cast<uint32_t>(value);
+    return true;
+}
+
+// Envia o que couber sem bloquear; false se a conexão caiu
+bool flush(Client& client) {
+    while (client.pending() > 0) {
+        const char* data;
+        size_t length;
+        if (client.sent < client.header.size()) {
+            data = client.header.data() + client.sent;
+            length = client.header.size() - client.sent;
+        } else {
+            size_t offset = client.sent - client.header.size();
+            data = client.frame->data() + offset;
+            length = client.frame->size() - offset;
+        }
+        ssize_t n = send(client.fd, data, length, MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        client.sent += static_cast<size_t>(n);
+    }
+    client.header.clear();
+    client.frame.reset();
+    client.sent = 0;
+    return true;
+}
+
+} // namespace
+
+FrameCache::FrameCache(size_t capacityBytes) : capacityBytes(capacityBytes), bytes(0) {}
+
+Frame FrameCache::find(const FrameKey& key) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->index.find(key);
+    if (it == this->index.end()) {
+        ++this->stats.misses;
+        return nullptr;
+    }
+    ++this->stats.hits;
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return it->second->frame;
+}
+
+void FrameCache::insert(const FrameKey& key, Frame frame) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!frame || frame->size() > this->capacityBytes) return;
+    auto it = this->index.find(key);
+    if (it != this->index.end()) {
+        // Render concorrente do mesmo quadro: mantém o que já está no cache
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+        return;
+    }
+
+    this->entries.push_front(Entry{key, frame});
+    this->index.emplace(key, this->entries.begin());
+    this->bytes += frame->size();
+    while (this->bytes > this->capacityBytes) {
+        const Entry& oldest = this->entries.back();
+        this->bytes -= oldest.frame->size();
+        this->index.erase(oldest.key);
+        this->entries.pop_back();
+        ++this->stats.evictions;
+    }
+}
+
+FrameCacheStats FrameCache::getStats() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    FrameCacheStats current = this->stats;
+    current.frames = this->entries.size();
+    current.bytes = this->bytes;
+    return current;
+}
+
+ImageService::ImageService(ReadingProvider provider, const ImageServiceConfig& config)
+    : provider(std::move(provider)),
+      config(config),
+      cache(config.cacheBytes),
+      listenFd(-1)
+{
+    if (this->config.counterStep < 1) this->config.counterStep = 1;
+    if (!(this->config.flowStep > 0.0f)) this->config.flowStep = 0.0001f;
+}
+
+ImageService::~ImageService() {
+    this->stop();
+}
+
+Frame ImageService::getFrame(uint32_t meter) {
+    MeterSnapshot snapshot;
+    float maxFlow = 0.0f;
+    if (!this->provider(meter, snapshot, maxFlow)) return nullptr;
+
+    FrameKey key;
+    key.meter = meter;
+    key.counter = floorDiv(snapshot.counter, this->config.counterStep);
+    key.flow = static_cast<int32_t>(std::lround(snapshot.flowIN * 3600.0f / this->config.flowStep));
+
+    Frame frame = this->cache.find(key);
+    if (frame) return frame;
+
+    // Desenha com os valores quantizados: o quadro vale para toda a chave
+    int32_t counter = key.counter * this->config.counterStep;
+    float flow = key.flow * this->config.flowStep / 3600.0f;
+    auto png = std::make_shared<std::string>();
+    {
+        std::lock_guard<std::mutex> lock(this->renderMutex);
+        this->image.render(counter, flow, maxFlow);
+        if (!this->image.encodePng(*png)) return nullptr;
+    }
+    frame = png;
+    this->cache.insert(key, frame);
+    return frame;
+}
+
+FrameCacheStats ImageService::getCacheStats() const { return this->cache.getStats(); }
+
+bool ImageService::start(const std::string& path) {
+    if (this->listenFd >= 0) return false;
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] ImageService::start - Caminho do socket longo demais: " + path);
+        return false;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] ImageService::start - socket falhou: " + std::string(strerror(errno)));
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 64) != 0 ||
+        !setNonBlocking(fd)) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] ImageService::start - Não foi possível escutar em " + path + ": " + strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    this->path = path;
+    this->listenFd = fd;
+    this->serverThread = std::thread(&ImageService::serveLoop, this);
+    return true;
+}
+
+void ImageService::stop() {
+    if (this->listenFd < 0) return;
+    this->stopSignal.requestStop();
+    if (this->serverThread.joinable()) this->serverThread.join();
+    close(this->listenFd);
+    unlink(this->path.c_str());
+    this->listenFd = -1;
+}
+
+bool ImageService::pinTo(const std::vector<int>& cpus) { return pinThread(this->serverThread, cpus); }
+
+void ImageService::serveLoop() {
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+
+    while (!this->stopSignal.stopRequested()) {
+        fds.clear();
+        fds.push_back(pollfd{this->stopSignal.fd(), POLLIN, 0});
+        fds.push_back(pollfd{this->listenFd, POLLIN, 0});
+        for (const Client& client : clients) {
+            // Uma resposta por vez: só lê o próximo pedido depois de enviar a anterior
+            fds.push_back(pollfd{client.fd, static_cast<short>(client.pending() > 0 ? POLLOUT : POLLIN), 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            Logger::log(LogLevel::RUNTIME, "[ERROR] ImageService::serveLoop - poll falhou: " + std::string(strerror(errno)));
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd;
+            while ((fd = accept4(this->listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                if (clients.size() >= static_cast<size_t>(MAX_CLIENTS)) {
+                    close(fd);
+                    continue;
+                }
+                clients.push_back(Client{fd, std::string(), std::string(), nullptr, 0});
+                // Sem eventos nesta passada; mantém fds[c + 2] pareado com clients[c]
+                fds.push_back(pollfd{fd, 0, 0});
+            }
+        }
+
+        for (size_t c = 0; c < clients.size(); ++c) {
+            Client& client = clients[c];
+            short revents = fds[c + 2].revents;
+            bool alive = !(revents & (POLLERR | POLLNVAL));
+
+            if (alive && (revents & POLLOUT)) alive = flush(client);
+
+            if (alive && (revents & (POLLIN | POLLHUP)) && client.pending() == 0) {
+                char buffer[MAX_REQUEST_BYTES];
+                ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+                if (n > 0) {
+                    client.input.append(buffer, static_cast<size_t>(n));
+                } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    alive = false;
+                }
+            }
+
+            // Atende os pedidos completos enquanto as respostas saem sem bloquear
+            size_t newline;
+            while (alive && client.pending() == 0 && (newline = client.input.find('\n')) != std::string::npos) {
+                std::string line = client.input.substr(0, newline);
+                client.input.erase(0, newline + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+
+                uint32_t meter = 0;
+                if (!parseRequest(line, meter)) {
+                    client.header = "ERR pedido inválido\n";
+                } else if ((client.frame = this->getFrame(meter))) {
+                    client.header = "OK " + std::to_string(client.frame->size()) + "\n";
+                } else {
+                    client.header = "ERR hidrômetro " + std::to_string(meter) + " inexistente\n";
+                }
+                alive = flush(client);
+            }
+            if (client.input.size() > MAX_REQUEST_BYTES && client.input.find('\n') == std::string::npos) {
+                alive = false;
+            }
+
+            if (!alive) {
+                close(client.fd);
+                clients[c] = std::move(clients.back());
+                clients.pop_back();
+                fds[c + 2] = fds.back();
+                fds.pop_back();
+                --c;
+            }
+        }
+    }
+
+    for (Client& client : clients) close(client.fd);
+}
@@ -0,0 +1,126 @@
+#ifndef IMAGE_SERVICE_H
+#define IMAGE_SERVICE_H
+
+#include "hidrometer.hpp"
+#include "../utils/image.hpp"
+#include "../utils/stop_signal.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Serviço local de imagens do mostrador com a leitura atual de um hidrômetro.
+//
+// Protocolo (socket Unix de stream, texto + binário, conexões persistentes):
+//
+//     cliente -> "GET <id>\n"
+//     serviço -> "OK <bytes>\n" seguido de <bytes> de PNG
+//             |  "ERR <mensagem>\n"
+//
+// As imagens são desenhadas sob demanda por Image e os PNGs codificados ficam
+// em um cache LRU indexado por (hidrômetro, leitura quantizada, vazão
+// quantizada): enquanto a leitura não muda, consultas repetidas só copiam
+// bytes do cache. Com a quantização padrão (1 L e 0.0001 m³/h, a precisão do
+// mostrador) a imagem servida mostra os mesmos números de um render com os
+// valores exatos.
+
+#define IMAGE_SERVICE_DEFAULT_PATH "/tmp/hydrometer_images.sock"
+
+struct ImageServiceConfig {
+    size_t cacheBytes = 64u << 20;   // orçamento do cache de quadros codificados
+    int32_t counterStep = 1;         // quantização da leitura (litros)
+    float flowStep = 0.0001f;        // quantização da vazão (m³/h)
+};
+
+struct FrameCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t frames = 0;
+    size_t bytes = 0;
+};
+
+// Chave de um quadro: hidrômetro e valores já quantizados
+struct FrameKey {
+    uint32_t meter;
+    int32_t counter;   // em passos de counterStep
+    int32_t flow;      // em passos de flowStep
+
+    bool operator==(const FrameKey& other) const {
+        return this->meter == other.meter && this->counter == other.counter && this->flow == other.flow;
+    }
+};
+
+struct FrameKeyHash {
+    size_t operator()(const FrameKey& key) const {
+        uint64_t h = (static_cast<uint64_t>(key.meter) << 32) ^ static_cast<uint32_t>(key.counter);
+        h ^= static_cast<uint64_t>(static_cast<uint32_t>(key.flow)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+using Frame = std::shared_ptr<const std::string>;
+
+// LRU de quadros PNG limitado em bytes (thread-safe)
+class FrameCache {
+public:
+    explicit FrameCache(size_t capacityBytes);
+
+    Frame find(const FrameKey& key);
+    void insert(const FrameKey& key, Frame frame);
+    FrameCacheStats getStats() const;
+
+private:
+    struct Entry {
+        FrameKey key;
+        Frame frame;
+    };
+
+    size_t capacityBytes;
+    size_t bytes;
+    std::list<Entry> entries;   // mais recente na frente
+    std::unordered_map<FrameKey, std::list<Entry>::iterator, FrameKeyHash> index;
+    FrameCacheStats stats;
+    mutable std::mutex mutex;
+};
+
+class ImageService {
+public:
+    // Leitura atual de um hidrômetro; false se o id não existe
+    using ReadingProvider = std::function<bool(uint32_t meter, MeterSnapshot& snapshot, float& maxFlow)>;
+
+    explicit ImageService(ReadingProvider provider, const ImageServiceConfig& config = ImageServiceConfig());
+    ~ImageService();
+
+    // Cria o socket em path e atende em uma thread própria
+    bool start(const std::string& path = IMAGE_SERVICE_DEFAULT_PATH);
+    void stop();
+    // Fixa a thread do serviço nas CPUs dadas (depois de start())
+    bool pinTo(const std::vector<int>& cpus);
+
+    // PNG do mostrador com a leitura atual (cache ou render); nullptr se o id não existe
+    Frame getFrame(uint32_t meter);
+
+    FrameCacheStats getCacheStats() const;
+
+private:
+    void serveLoop();
+
+    ReadingProvider provider;
+    ImageServiceConfig config;
+    FrameCache cache;
+    Image image;
+    std::mutex renderMutex;   // Image tem uma única superfície
+    std::string path;
+    int listenFd;
+    StopSignal stopSignal;
+    std::thread serverThread;
+};
+
+#endif // IMAGE_SERVICE_H
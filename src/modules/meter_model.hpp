@@ -0,0 +1,107 @@
+#ifndef METER_MODEL_H
+#define METER_MODEL_H
+
+#include "pipe.hpp"
+#include "../utils/constexpr_math.hpp"
+
+// Modelos de hidrômetro como tipos de compilação: geometria constexpr e
+// vazão máxima resolvida pelo compilador (mesma iteração de
+// Pipe::maxFlowForDeltaP), eliminando a solução no construtor de Pipe.
+
+struct PipeGeometry {
+    float diameter;   // m
+    float length;     // m
+    float roughness;  // m
+    float maxFlow;    // m³/s para DEFAULT_DELTA_P
+};
+
+struct MeterGeometry {
+    PipeGeometry in;
+    PipeGeometry out;
+};
+
+// Versão constexpr de Pipe::maxFlowForDeltaP (Darcy-Weisbach + Swamee-Jain)
+constexpr double solveMaxFlow(double diameter, double length, double roughness, double deltaP,
+                              double rho = RHO, double mu = MU, double g = G) {
+    if (diameter <= 0 || length <= 0 || deltaP <= 0) {
+        return 0.0;
+    }
+
+    double V = 1.0;
+    for (int iter = 0; iter < 100; ++iter) {
+        double Re = (rho * V * diameter) / mu;
+        double f = 0.0;
+        if (Re < 2000.0) {
+            f = 64.0 / Re;
+        } else {
+            double term = (roughness / (3.7 * diameter)) + (5.74 / cmath::pow(Re, 0.9));
+            double l = cmath::log10(term);
+            f = 0.25 / (l * l);
+        }
+
+        double hf = deltaP / (rho * g);
+        double V_new = cmath::sqrt((2.0 * g * hf * diameter) / (f * length));
+        if (cmath::abs(V_new - V) < 1e-9) {
+            V = V_new;
+            break;
+        }
+        V = V_new;
+    }
+
+    double area = M_PI * (diameter * diameter) / 4.0;
+    return V * area;
+}
+
+constexpr PipeGeometry makePipeGeometry(float diameter, float length, float roughness) {
+    return PipeGeometry{diameter, length, roughness,
+                        static_cast<float>(solveMaxFlow(diameter, length, roughness, DEFAULT_DELTA_P))};
+}
+
+constexpr MeterGeometry makeMeterGeometry(float diameter, float length, float roughness) {
+    return MeterGeometry{makePipeGeometry(diameter, length, roughness),
+                         makePipeGeometry(diameter, length, roughness)};
+}
+
+// Geometria conhecida só em tempo de execução (ex.: arquivo de definição da
+// frota): mesma solução, feita por Pipe::solveVelocity
+inline PipeGeometry solvePipeGeometry(float diameter, float length, float roughness) {
+    double v = Pipe::solveVelocity(diameter, length, roughness, DEFAULT_DELTA_P);
+    double area = M_PI * (static_cast<double>(diameter) * diameter) / 4.0;
+    return PipeGeometry{diameter, length, roughness, static_cast<float>(v * area)};
+}
+
+inline MeterGeometry solveMeterGeometry(float diameter, float length, float roughness) {
+    PipeGeometry pipe = solvePipeGeometry(diameter, length, roughness);
+    return MeterGeometry{pipe, pipe};
+}
+
+// Tubos de entrada e saída diferentes (ex.: tolerâncias de fabricação)
+inline MeterGeometry solveMeterGeometry(const PipeGeometry& in, const PipeGeometry& out) {
+    return MeterGeometry{solvePipeGeometry(in.diameter, in.length, in.roughness),
+                         solvePipeGeometry(out.diameter, out.length, out.roughness)};
+}
+
+// Residencial 15 mm (geometria padrão de Hidrometer)
+struct Residential15 {
+    static constexpr const char* NAME = "R15";
+    static constexpr MeterGeometry GEOMETRY = makeMeterGeometry(0.015f, 0.15f, 0.00005f);
+};
+
+// Residencial 20 mm
+struct Residential20 {
+    static constexpr const char* NAME = "R20";
+    static constexpr MeterGeometry GEOMETRY = makeMeterGeometry(0.020f, 0.19f, 0.00005f);
+};
+
+// Comercial 50 mm
+struct Commercial50 {
+    static constexpr const char* NAME = "C50";
+    static constexpr MeterGeometry GEOMETRY = makeMeterGeometry(0.050f, 0.30f, 0.0001f);
+};
+
+static_assert(Residential15::GEOMETRY.in.maxFlow > 0.0f, "vazão máxima não resolvida em compilação");
+static_assert(Commercial50::GEOMETRY.in.maxFlow > Residential20::GEOMETRY.in.maxFlow &&
+              Residential20::GEOMETRY.in.maxFlow > Residential15::GEOMETRY.in.maxFlow,
+              "capacidade deve crescer com o diâmetro");
+
+#endif // METER_MODEL_H
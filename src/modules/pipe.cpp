@@ -8,15 +8,25 @@
             this->diameter = diameter;
             this->length = length;
             this->roughness = roughness;
-            this->flowRate = 0.0;
+            this->flowRate.store(0.0f);
             
-            this->maxFlow = this->maxFlowForDeltaP(1000000.0); // deltaP padrão de 1000kPa (aumentado para testes)
+            this->maxFlow = this->maxFlowForDeltaP(DEFAULT_DELTA_P); // deltaP padrão de 1000kPa (aumentado para testes)
+        }
+
+    Pipe::Pipe(float diameter, float length, float roughness, float maxFlow){
+
+            this->diameter = diameter;
+            this->length = length;
+            this->roughness = roughness;
+            this->flowRate.store(0.0f);
+
+            this->maxFlow = maxFlow;
         }
 
     float Pipe::getDiameter() const { return this->diameter; }
     float Pipe::getLength() const { return this->length; }
     float Pipe::getRoughness() const { return this->roughness; }
-    float Pipe::getFlowRate() const { return this->flowRate; }
+    float Pipe::getFlowRate() const { return this->flowRate.load(); }
     float Pipe::getMaxFlow() const { return this->maxFlow; }
 
     // Retorna vazão (m^3/s) para uma queda de pressão deltaP (Pa)
@@ -25,15 +35,29 @@
                             double mu,       // Pa·s
                             double g) const  // m/s^2
     {
-        
-        if (this->diameter <= 0 || this->length <= 0 || deltaP <= 0) {
+        double V = Pipe::solveVelocity(this->diameter, this->length, this->roughness, deltaP,
+                                       0.0, 1.0, nullptr, rho, mu, g);
+
+        double area = M_PI * pow(diameter, 2) / 4.0;
+        double flowRate = V * area;
+                
+        return flowRate;
+    }
+
+    double Pipe::solveVelocity(double diameter, double length, double roughness, double deltaP,
+                               double valveK, double V0, int* iterations,
+                               double rho, double mu, double g)
+    {
+        if (iterations) *iterations = 0;
+        if (diameter <= 0 || length <= 0 || deltaP <= 0) {
             return 0.0;
         }
 
-        double V = 1.0;
+        double V = V0 > 0.0 ? V0 : 1.0;
         
         for (int iter = 0; iter < 100; ++iter) {
-            double Re = (rho * V * this->diameter) / mu;
+            if (iterations) *iterations = iter + 1;
+            double Re = (rho * V * diameter) / mu;
             double f;
             if (Re < 2000.0) {
                 f = 64.0 / Re;
@@ -43,35 +67,33 @@
                 f = 0.25 / (pow(log10(term), 2.0));
             }
 
+            // deltaP = (f*L/D + K) * rho*V²/2; com K = 0 é a forma original 2*g*hf*D/(f*L)
             double hf = deltaP / (rho * g); // m
-            double V_new = sqrt((2.0 * g * hf * diameter) / (f * length));
+            double V_new = sqrt((2.0 * g * hf * diameter) / (f * length + valveK * diameter));
 
-            if (abs(V_new - V) < 1e-9) { 
+            if (std::abs(V_new - V) < 1e-9) { 
                 V = V_new; 
                 break; 
             }
             V = V_new;
         }
 
-        double area = M_PI * pow(diameter, 2) / 4.0;
-        double flowRate = V * area;
-                
-        return flowRate;
+        return V;
     }
 
     void Pipe::setFlowRate(float flowRate_IN) {
         if (flowRate_IN < 0.0f){
-            Logger::log(LogLevel::DEBUG, "[DEBUG] Pipe::setFlowRate - Vazão mínima atingida (" + std::to_string(this->flowRate) + " m³/s)");
+            Logger::log(LogLevel::DEBUG, "[DEBUG] Pipe::setFlowRate - Vazão mínima atingida (" + std::to_string(this->flowRate.load()) + " m³/s)");
             return;
         }
         
         // Usa tolerância de 0.1% para comparação de floats
         const float tolerance = 0.001f; // 0.1%
         if (flowRate_IN > this->maxFlow * (1.0f + tolerance)) {
-            Logger::log(LogLevel::DEBUG, "[DEBUG] Pipe::setFlowRate - Vazão máxima atingida (" + std::to_string(this->flowRate) + " m³/s)");
+            Logger::log(LogLevel::DEBUG, "[DEBUG] Pipe::setFlowRate - Vazão máxima atingida (" + std::to_string(this->flowRate.load()) + " m³/s)");
             return;
         }
         
         // Limita ao maxFlow se estiver próximo
-        this->flowRate = std::min(flowRate_IN, this->maxFlow);
+        this->flowRate.store(std::min(flowRate_IN, this->maxFlow));
     }
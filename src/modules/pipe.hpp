@@ -2,17 +2,21 @@
 #define PIPE_H
 
 #include <algorithm> // para min
+#include <atomic>
 #include <cmath>     // para sqrt, log10, pow
 
 #define M_PI 3.14159265358979323846
 #define RHO 998.0          // kg/m^3
 #define MU 1.002e-3       // Pa·s
 #define G 9.80665         // m/s^2
+#define DEFAULT_DELTA_P 1000000.0 // Pa, deltaP usado para a vazão máxima
 
 class Pipe {
 
 public:
     Pipe(float diameter, float length, float roughness); 
+    // Vazão máxima já conhecida (ex.: resolvida em compilação, ver meter_model.hpp)
+    Pipe(float diameter, float length, float roughness, float maxFlow);
 
     float getDiameter() const;
     float getLength() const;
@@ -26,10 +30,19 @@ public:
                             double mu  = MU,       // Pa·s
                             double g   = G) const;  // m/s^2
 
+    // Velocidade média (m/s) em regime para a queda deltaP (Pa) com uma perda
+    // localizada extra valveK (válvula; 0 = totalmente aberta). A iteração parte
+    // de V0, o que permite reaproveitar a solução do tick anterior; iterations
+    // recebe o número de iterações usadas.
+    static double solveVelocity(double diameter, double length, double roughness, double deltaP,
+                                double valveK = 0.0, double V0 = 1.0, int* iterations = nullptr,
+                                double rho = RHO, double mu = MU, double g = G);
+
     void setFlowRate(float flowRate);
 
 private:
-    float flowRate;
+    // Escrita pela thread de controle/atualização e lida por várias outras
+    std::atomic<float> flowRate;
     float maxFlow;
     float diameter;
     float length;
@@ -0,0 +1,141 @@
+#include "pressure_flow.hpp"
+#include "../utils/logger.hpp"
+#include <cmath>
+
+PressureFlowSolver::PressureFlowSolver(const std::vector<PipeGeometry>& models,
+                                       const std::vector<uint16_t>& meterModel,
+                                       const PressureFlowConfig& config)
+    : config(config),
+      models(models),
+      meterModel(meterModel),
+      pressure(meterModel.size(), 0.0f),
+      opening(meterModel.size(), 1.0f),
+      solvedPressure(meterModel.size(), 0.0f),
+      solvedOpening(meterModel.size(), 1.0f),
+      velocity(meterModel.size(), 0.0f),
+      flow(meterModel.size(), 0.0f),
+      solves(0),
+      skips(0),
+      iterations(0)
+{
+    for (size_t i = 0; i < this->meterModel.size(); ++i) {
+        if (this->meterModel[i] >= this->models.size()) {
+            Logger::log(LogLevel::STARTUP, "[ERROR] PressureFlowSolver - Modelo inválido para o hidrômetro " + std::to_string(i));
+            this->meterModel[i] = 0;
+        }
+    }
+}
+
+void PressureFlowSolver::setSupplyPressure(uint32_t meter, float pascal) {
+    this->pressure[meter] = pascal > 0.0f ? pascal : 0.0f;
+}
+
+void PressureFlowSolver::setSupplyPressureAll(float pascal) {
+    for (size_t i = 0; i < this->pressure.size(); ++i) {
+        this->setSupplyPressure(static_cast<uint32_t>(i), pascal);
+    }
+}
+
+void PressureFlowSolver::setOpening(uint32_t meter, float opening) {
+    this->opening[meter] = opening < 0.0f ? 0.0f : (opening > 1.0f ? 1.0f : opening);
+}
+
+size_t PressureFlowSolver::solve(std::vector<uint32_t>* solvedMeters) {
+    size_t solved = 0;
+    if (solvedMeters) solvedMeters->clear();
+    const double valveK = this->config.valveK;
+
+    for (size_t i = 0; i < this->meterModel.size(); ++i) {
+        float p = this->pressure[i];
+        float a = this->opening[i];
+
+        // Entradas praticamente iguais às da última solução: mantém a vazão
+        float dp = std::fabs(p - this->solvedPressure[i]);
+        float da = std::fabs(a - this->solvedOpening[i]);
+        if (dp <= this->config.pressureTol * this->solvedPressure[i] && da <= this->config.openingTol) {
+            ++this->skips;
+            continue;
+        }
+
+        float previousPressure = this->solvedPressure[i];
+        this->solvedPressure[i] = p;
+        this->solvedOpening[i] = a;
+        ++solved;
+        if (solvedMeters) solvedMeters->push_back(static_cast<uint32_t>(i));
+
+        if (p <= 0.0f || a < this->config.minOpening) {
+            this->velocity[i] = 0.0f;
+            this->flow[i] = 0.0f;
+            continue;
+        }
+
+        const PipeGeometry& geometry = this->models[this->meterModel[i]];
+        double k = valveK * (1.0 / (static_cast<double>(a) * a) - 1.0);
+        // Warm start: V do tick anterior corrigido por sqrt(p/p_anterior) (V ~ sqrt(deltaP))
+        double v0 = 1.0;
+        if (this->config.warmStart && this->velocity[i] > 0.0f && previousPressure > 0.0f) {
+            v0 = this->velocity[i] * std::sqrt(static_cast<double>(p) / previousPressure);
+        }
+        int used = 0;
+        double v = Pipe::solveVelocity(geometry.diameter, geometry.length, geometry.roughness, p, k, v0, &used);
+        this->iterations += static_cast<uint64_t>(used);
+
+        double area = M_PI * static_cast<double>(geometry.diameter) * geometry.diameter / 4.0;
+        this->velocity[i] = static_cast<float>(v);
+        this->flow[i] = static_cast<float>(v * area);
+    }
+
+    this->solves += solved;
+    return solved;
+}
+
+float PressureFlowSolver::getFlow(uint32_t meter) const { return this->flow[meter]; }
+const float* PressureFlowSolver::getFlows() const { return this->flow.data(); }
+float PressureFlowSolver::getVelocity(uint32_t meter) const { return this->velocity[meter]; }
+
+size_t PressureFlowSolver::size() const { return this->meterModel.size(); }
+uint64_t PressureFlowSolver::getSolveCount() const { return this->solves; }
+uint64_t PressureFlowSolver::getSkipCount() const { return this->skips; }
+uint64_t PressureFlowSolver::getIterationCount() const { return this->iterations; }
+
+PressureDrivenFleet::PressureDrivenFleet(StandardFleet& fleet, const PressureFlowConfig& config)
+    : fleet(fleet),
+      solver(makeSolver(fleet, config)),
+      rejected(0) {}
+
+// Modelos do solver: os de compilação nos primeiros índices, depois as
+// geometrias do lote de geometrias (entrada do hidrômetro)
+PressureFlowSolver PressureDrivenFleet::makeSolver(const StandardFleet& fleet, const PressureFlowConfig& config) {
+    std::vector<PipeGeometry> models;
+    for (size_t m = 0; m < StandardFleet::MODEL_COUNT; ++m) models.push_back(StandardFleet::modelGeometry(m).in);
+    const GeometryBatch& custom = fleet.getCustomBatch();
+    for (size_t g = 0; g < custom.geometryCount(); ++g) models.push_back(custom.getGeometry(static_cast<uint16_t>(g)).in);
+    if (models.size() > UINT16_MAX + 1u) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] PressureDrivenFleet - Geometrias demais para o solver; excedentes usam o modelo 0");
+    }
+
+    std::vector<uint16_t> meterModel(fleet.size());
+    for (uint32_t id = 0; id < fleet.size(); ++id) {
+        StandardFleet::MeterRef ref = fleet.getRef(id);
+        size_t model = ref.model == StandardFleet::CUSTOM_MODEL
+                     ? StandardFleet::MODEL_COUNT + custom.getGeometryIndex(ref.index) : ref.model;
+        meterModel[id] = static_cast<uint16_t>(model <= UINT16_MAX ? model : 0);
+    }
+    return PressureFlowSolver(models, meterModel, config);
+}
+
+void PressureDrivenFleet::setSupplyPressure(uint32_t meter, float pascal) { this->solver.setSupplyPressure(meter, pascal); }
+void PressureDrivenFleet::setSupplyPressureAll(float pascal) { this->solver.setSupplyPressureAll(pascal); }
+void PressureDrivenFleet::setOpening(uint32_t meter, float opening) { this->solver.setOpening(meter, opening); }
+
+size_t PressureDrivenFleet::tick(float dt) {
+    size_t count = this->solver.solve(&this->solved);
+    for (uint32_t meter : this->solved) {
+        if (!this->fleet.setFlowRate(meter, this->solver.getFlow(meter))) ++this->rejected;
+    }
+    this->fleet.tick(dt);
+    return count;
+}
+
+const PressureFlowSolver& PressureDrivenFleet::getSolver() const { return this->solver; }
+uint64_t PressureDrivenFleet::getRejectedCount() const { return this->rejected; }
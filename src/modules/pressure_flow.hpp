@@ -0,0 +1,97 @@
+#ifndef PRESSURE_FLOW_H
+#define PRESSURE_FLOW_H
+
+#include "fleet.hpp"
+#include "meter_model.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Vazão dirigida por pressão: a cada tick a vazão de cada hidrômetro sai da
+// pressão de alimentação e da abertura da válvula, resolvendo
+// Darcy-Weisbach/Swamee-Jain (Pipe::solveVelocity) com a perda da válvula.
+//
+// Para manter o custo por tick baixo em frotas grandes:
+//  - cada solução parte da velocidade do tick anterior (warm start), o que
+//    reduz a iteração a poucas voltas quando as entradas variam pouco;
+//  - hidrômetros cujas entradas mudaram menos que a tolerância desde a última
+//    solução não são resolvidos de novo.
+//
+// Na frota em lote é usado por PressureDrivenFleet (simulator --pressure N).
+
+struct PressureFlowConfig {
+    float pressureTol = 1e-4f;   // variação relativa de pressão que dispensa nova solução
+    float openingTol = 1e-4f;    // variação absoluta de abertura que dispensa nova solução
+    float valveK = 1.0f;         // perda da válvula: K(abertura) = valveK * (1/abertura² - 1)
+    float minOpening = 1e-3f;    // abaixo disso a válvula é tratada como fechada
+    bool warmStart = true;       // false: toda solução parte de V = 1.0 (comparação)
+};
+
+class PressureFlowSolver {
+public:
+    // models: geometria de entrada de cada modelo; meterModel[i]: modelo do hidrômetro i
+    PressureFlowSolver(const std::vector<PipeGeometry>& models, const std::vector<uint16_t>& meterModel,
+                       const PressureFlowConfig& config = PressureFlowConfig());
+
+    void setSupplyPressure(uint32_t meter, float pascal);
+    void setSupplyPressureAll(float pascal);
+    void setOpening(uint32_t meter, float opening);   // 0 = fechada, 1 = totalmente aberta
+
+    // Resolve os hidrômetros cujas entradas mudaram além da tolerância.
+    // Retorna quantos foram resolvidos neste tick (e, se pedido, quais).
+    size_t solve(std::vector<uint32_t>* solved = nullptr);
+
+    float getFlow(uint32_t meter) const;              // m³/s
+    const float* getFlows() const;
+    float getVelocity(uint32_t meter) const;          // m/s
+
+    size_t size() const;
+    uint64_t getSolveCount() const;
+    uint64_t getSkipCount() const;
+    uint64_t getIterationCount() const;
+
+private:
+    PressureFlowConfig config;
+    std::vector<PipeGeometry> models;
+    std::vector<uint16_t> meterModel;
+    std::vector<float> pressure;        // entradas atuais
+    std::vector<float> opening;
+    std::vector<float> solvedPressure;  // entradas da última solução
+    std::vector<float> solvedOpening;
+    std::vector<float> velocity;        // última solução (chute do próximo tick)
+    std::vector<float> flow;
+    uint64_t solves;
+    uint64_t skips;
+    uint64_t iterations;
+};
+
+// Frota em lote dirigida por pressão: a cada tick o solver resolve quem teve
+// pressão ou abertura alterada e as novas vazões são aplicadas com
+// Fleet::setFlowRate (mesma recusa de Pipe::setFlowRate acima da vazão
+// máxima) antes do tick da frota. A frota deve estar completa na construção;
+// depois, setFlowRate direto na frota é sobrescrito na próxima solução do
+// hidrômetro.
+class PressureDrivenFleet {
+public:
+    explicit PressureDrivenFleet(StandardFleet& fleet, const PressureFlowConfig& config = PressureFlowConfig());
+
+    void setSupplyPressure(uint32_t meter, float pascal);
+    void setSupplyPressureAll(float pascal);
+    void setOpening(uint32_t meter, float opening);
+
+    // Resolve, aplica as vazões e avança a frota; retorna quantos foram resolvidos
+    size_t tick(float dt = FLEET_TICK_SECONDS);
+
+    const PressureFlowSolver& getSolver() const;
+    uint64_t getRejectedCount() const;   // vazões acima de maxFlow*(1+0.1%) recusadas pela frota
+
+private:
+    static PressureFlowSolver makeSolver(const StandardFleet& fleet, const PressureFlowConfig& config);
+
+    StandardFleet& fleet;
+    PressureFlowSolver solver;
+    std::vector<uint32_t> solved;
+    uint64_t rejected;
+};
+
+#endif // PRESSURE_FLOW_H
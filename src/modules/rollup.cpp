@@ -0,0 +1,295 @@
+#include "rollup.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace {
+
+const int32_t EMPTY_BUCKET = std::numeric_limits<int32_t>::min();
+const int32_t EMPTY_COUNTER = std::numeric_limits<int32_t>::min();
+
+int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+int64_t ceilDiv(int64_t a, int64_t b) {
+    return -floorDiv(-a, b);
+}
+
+// Conversões de calendário civil (proléptico gregoriano, UTC)
+int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    const int32_t era = (y >= 0 ? y : y - 399) / 400;
+    const uint32_t yoe = static_cast<uint32_t>(y - era * 400);
+    const uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int32_t>(doe) - 719468;
+}
+
+int32_t monthOfDay(int32_t day) {
+    const int32_t z = day + 719468;
+    const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const uint32_t doe = static_cast<uint32_t>(z - era * 146097);
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint32_t mp = (5 * doy + 2) / 153;
+    const uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+    const int32_t y = static_cast<int32_t>(yoe) + era * 400 + (m <= 2);
+    return y * 12 + static_cast<int32_t>(m) - 1;
+}
+
+int32_t monthStartDay(int32_t month) {
+    return daysFromCivil(static_cast<int32_t>(floorDiv(month, 12)),
+                         static_cast<uint32_t>(month - floorDiv(month, 12) * 12) + 1, 1);
+}
+
+// Árvore de Fenwick sobre um anel de n slots (índices 0..n-1)
+template <typename T>
+void fenwickAdd(T* tree, uint32_t n, uint32_t slot, T delta) {
+    for (uint32_t i = slot + 1; i <= n; i += i & (0u - i)) tree[i - 1] += delta;
+}
+
+template <typename T>
+T fenwickPrefix(const T* tree, uint32_t slot) {
+    T total = 0;
+    for (uint32_t i = slot + 1; i > 0; i -= i & (0u - i)) total += tree[i - 1];
+    return total;
+}
+
+template <typename T>
+T fenwickRange(const T* tree, uint32_t s0, uint32_t s1) {
+    return fenwickPrefix(tree, s1) - (s0 > 0 ? fenwickPrefix(tree, s0 - 1) : T(0));
+}
+
+uint32_t slotOf(int32_t bucket, uint32_t n) {
+    int64_t s = bucket % static_cast<int64_t>(n);
+    return static_cast<uint32_t>(s < 0 ? s + n : s);
+}
+
+} // namespace
+
+template <typename T>
+RollupSeries<T>::RollupSeries(size_t seriesCount, const RollupConfig& config)
+    : seriesCount(seriesCount) {
+    this->sizes[HOUR] = std::max<uint32_t>(config.hours, 1);
+    this->sizes[DAY] = std::max<uint32_t>(config.days, 1);
+    this->sizes[MONTH] = std::max<uint32_t>(config.months, 1);
+    this->offsets[HOUR] = 0;
+    this->offsets[DAY] = this->sizes[HOUR];
+    this->offsets[MONTH] = this->sizes[HOUR] + this->sizes[DAY];
+    this->stride = this->sizes[HOUR] + this->sizes[DAY] + this->sizes[MONTH];
+    this->trees.assign(seriesCount * this->stride, T(0));
+    this->heads.assign(seriesCount * LEVELS, EMPTY_BUCKET);
+}
+
+template <typename T>
+T* RollupSeries<T>::tree(size_t series, int level) {
+    return this->trees.data() + series * this->stride + this->offsets[level];
+}
+
+template <typename T>
+const T* RollupSeries<T>::tree(size_t series, int level) const {
+    return this->trees.data() + series * this->stride + this->offsets[level];
+}
+
+template <typename T>
+void RollupSeries<T>::addLevel(size_t series, int level, int32_t bucket, T delta) {
+    const uint32_t n = this->sizes[level];
+    T* t = this->tree(series, level);
+    int32_t& head = this->heads[series * LEVELS + level];
+
+    if (head == EMPTY_BUCKET) {
+        head = bucket;
+    } else if (bucket > head) {
+        // Avança o anel: zera os baldes reutilizados entre head+1 e bucket
+        if (static_cast<int64_t>(bucket) - head >= n) {
+            std::fill(t, t + n, T(0));
+        } else {
+            for (int32_t b = head + 1; b <= bucket; ++b) {
+                uint32_t s = slotOf(b, n);
+                T current = fenwickRange(t, s, s);
+                fenwickAdd(t, n, s, T(0) - current);
+            }
+        }
+        head = bucket;
+    } else if (static_cast<int64_t>(bucket) <= static_cast<int64_t>(head) - n) {
+        return; // leitura atrasada, fora da retenção deste nível
+    }
+
+    fenwickAdd(t, n, slotOf(bucket, n), delta);
+}
+
+template <typename T>
+void RollupSeries<T>::add(size_t series, int32_t hour, T delta) {
+    const int32_t day = static_cast<int32_t>(floorDiv(hour, 24));
+    this->addLevel(series, HOUR, hour, delta);
+    this->addLevel(series, DAY, day, delta);
+    this->addLevel(series, MONTH, monthOfDay(day), delta);
+}
+
+template <typename T>
+bool RollupSeries<T>::covered(size_t series, int level, int32_t b0, int32_t b1) const {
+    const int32_t head = this->heads[series * LEVELS + level];
+    if (head == EMPTY_BUCKET) return true;
+    b1 = std::min<int64_t>(b1, static_cast<int64_t>(head) + 1);
+    if (b0 >= b1) return true;
+    return static_cast<int64_t>(b0) > static_cast<int64_t>(head) - this->sizes[level];
+}
+
+template <typename T>
+T RollupSeries<T>::rangeLevel(size_t series, int level, int32_t b0, int32_t b1) const {
+    const int32_t head = this->heads[series * LEVELS + level];
+    if (head == EMPTY_BUCKET) return T(0);
+    b1 = std::min<int64_t>(b1, static_cast<int64_t>(head) + 1);
+    if (b0 >= b1) return T(0);
+
+    const uint32_t n = this->sizes[level];
+    const T* t = this->tree(series, level);
+    const uint32_t s0 = slotOf(b0, n);
+    const uint32_t s1 = slotOf(b1 - 1, n);
+    if (s0 <= s1) return fenwickRange(t, s0, s1);
+    return fenwickRange(t, s0, n - 1) + fenwickPrefix(t, s1);
+}
+
+template <typename T>
+bool RollupSeries<T>::sumDays(size_t series, int32_t d0, int32_t d1, T& out) const {
+    if (this->covered(series, DAY, d0, d1)) {
+        out = this->rangeLevel(series, DAY, d0, d1);
+        return true;
+    }
+
+    // Meses inteiros no meio, dias nas bordas
+    int32_t m0 = monthOfDay(d0);
+    if (monthStartDay(m0) != d0) ++m0;
+    const int32_t m1 = monthOfDay(d1);
+    if (m0 >= m1) return false;
+
+    const int32_t head = monthStartDay(m0);
+    const int32_t tail = monthStartDay(m1);
+    if (!this->covered(series, DAY, d0, head) || !this->covered(series, DAY, tail, d1) ||
+        !this->covered(series, MONTH, m0, m1)) {
+        return false;
+    }
+    out = this->rangeLevel(series, DAY, d0, head) + this->rangeLevel(series, MONTH, m0, m1) +
+          this->rangeLevel(series, DAY, tail, d1);
+    return true;
+}
+
+template <typename T>
+bool RollupSeries<T>::sum(size_t series, int32_t hour0, int32_t hour1, T& out) const {
+    out = T(0);
+    if (hour0 >= hour1) return true;
+    if (this->covered(series, HOUR, hour0, hour1)) {
+        out = this->rangeLevel(series, HOUR, hour0, hour1);
+        return true;
+    }
+
+    // Dias inteiros no meio, horas nas bordas
+    const int32_t d0 = static_cast<int32_t>(ceilDiv(hour0, 24));
+    const int32_t d1 = static_cast<int32_t>(floorDiv(hour1, 24));
+    if (d0 >= d1) return false;
+
+    if (!this->covered(series, HOUR, hour0, d0 * 24) || !this->covered(series, HOUR, d1 * 24, hour1)) {
+        return false;
+    }
+    T middle;
+    if (!this->sumDays(series, d0, d1, middle)) return false;
+    out = this->rangeLevel(series, HOUR, hour0, d0 * 24) + middle + this->rangeLevel(series, HOUR, d1 * 24, hour1);
+    return true;
+}
+
+template <typename T>
+size_t RollupSeries<T>::bytesPerSeries() const {
+    return this->stride * sizeof(T) + LEVELS * sizeof(int32_t);
+}
+
+template class RollupSeries<uint32_t>;
+template class RollupSeries<int64_t>;
+
+ConsumptionRollup::ConsumptionRollup(const std::vector<uint32_t>& meterGroup, size_t groupCount,
+                                     const RollupConfig& config)
+    : meterGroup(meterGroup),
+      lastCounter(meterGroup.size(), EMPTY_COUNTER),
+      meters(meterGroup.size(), config),
+      groups(groupCount, config) {
+    // Índice dos membros de cada grupo (ordem crescente de id)
+    this->groupStart.assign(groupCount + 1, 0);
+    for (uint32_t g : meterGroup) ++this->groupStart[g + 1];
+    for (size_t g = 0; g < groupCount; ++g) this->groupStart[g + 1] += this->groupStart[g];
+    this->groupMembers.resize(meterGroup.size());
+    std::vector<uint32_t> next(this->groupStart.begin(), this->groupStart.end() - 1);
+    for (size_t i = 0; i < meterGroup.size(); ++i) this->groupMembers[next[meterGroup[i]]++] = static_cast<uint32_t>(i);
+}
+
+void ConsumptionRollup::record(uint32_t meter, int32_t counter, int64_t unixSeconds) {
+    const int32_t last = this->lastCounter[meter];
+    this->lastCounter[meter] = counter;
+    // Primeira leitura só define a referência; retrocesso (troca/reset) é ignorado
+    if (last == EMPTY_COUNTER || counter <= last) return;
+
+    const int32_t hour = static_cast<int32_t>(floorDiv(unixSeconds, 3600));
+    const uint32_t delta = static_cast<uint32_t>(counter - last);
+    this->meters.add(meter, hour, delta);
+    this->groups.add(this->meterGroup[meter], hour, static_cast<int64_t>(delta));
+}
+
+void ConsumptionRollup::recordAll(const int32_t* counters, int64_t unixSeconds) {
+    for (size_t i = 0; i < this->meterGroup.size(); ++i) {
+        this->record(static_cast<uint32_t>(i), counters[i], unixSeconds);
+    }
+}
+
+bool ConsumptionRollup::meterConsumption(uint32_t meter, int64_t from, int64_t to, int64_t& liters) const {
+    uint32_t total = 0;
+    bool ok = this->meters.sum(meter, static_cast<int32_t>(floorDiv(from, 3600)),
+                               static_cast<int32_t>(ceilDiv(to, 3600)), total);
+    liters = total;
+    return ok;
+}
+
+bool ConsumptionRollup::groupConsumption(uint32_t group, int64_t from, int64_t to, int64_t& liters) const {
+    return this->groups.sum(group, static_cast<int32_t>(floorDiv(from, 3600)),
+                            static_cast<int32_t>(ceilDiv(to, 3600)), liters);
+}
+
+std::vector<std::pair<uint32_t, int64_t>> ConsumptionRollup::topConsumers(size_t k, int64_t from, int64_t to,
+                                                                         int64_t group) const {
+    typedef std::pair<int64_t, uint32_t> Entry; // (litros, hidrômetro)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+
+    const int32_t hour0 = static_cast<int32_t>(floorDiv(from, 3600));
+    const int32_t hour1 = static_cast<int32_t>(ceilDiv(to, 3600));
+    // Só os membros do grupo quando filtrado
+    const bool filtered = group >= 0;
+    if (filtered && static_cast<size_t>(group) + 1 >= this->groupStart.size()) return {};
+    const size_t first = filtered ? this->groupStart[group] : 0;
+    const size_t last = filtered ? this->groupStart[group + 1] : this->meterGroup.size();
+    for (size_t j = first; j < last && k > 0; ++j) {
+        const size_t i = filtered ? this->groupMembers[j] : j;
+        uint32_t liters = 0;
+        if (!this->meters.sum(i, hour0, hour1, liters) || liters == 0) continue;
+        if (heap.size() < k) {
+            heap.push(Entry(liters, static_cast<uint32_t>(i)));
+        } else if (static_cast<int64_t>(liters) > heap.top().first) {
+            heap.pop();
+            heap.push(Entry(liters, static_cast<uint32_t>(i)));
+        }
+    }
+
+    std::vector<std::pair<uint32_t, int64_t>> result;
+    result.reserve(heap.size());
+    while (!heap.empty()) {
+        result.push_back(std::make_pair(heap.top().second, heap.top().first));
+        heap.pop();
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+size_t ConsumptionRollup::getMeterCount() const { return this->meterGroup.size(); }
+
+size_t ConsumptionRollup::bytesPerMeter() const {
+    return this->meters.bytesPerSeries() + sizeof(int32_t) + sizeof(uint32_t);
+}
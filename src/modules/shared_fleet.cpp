@@ -0,0 +1,193 @@
+#include "shared_fleet.hpp"
+#include "../utils/logger.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Processo escritor ainda vivo de um segmento existente, ou 0 se o segmento
+// puder ser removido: encerrado, de outro layout, sem pid (1.0) ou com o
+// escritor morto
+pid_t liveWriter(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) return 0;
+    struct stat st;
+    void* mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SharedFleetHeader)) {
+        mem = mmap(nullptr, sizeof(SharedFleetHeader), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mem == MAP_FAILED) return 0;
+
+    const SharedFleetHeader* hdr = static_cast<const SharedFleetHeader*>(mem);
+    pid_t pid = 0;
+    if (hdr->magic == SHARED_FLEET_MAGIC && hdr->versionMajor == SHARED_FLEET_VERSION_MAJOR &&
+        hdr->state.load(std::memory_order_acquire) != static_cast<uint32_t>(SharedFleetState::CLOSED)) {
+        pid = static_cast<pid_t>(hdr->writerPid);
+    }
+    munmap(mem, sizeof(SharedFleetHeader));
+    // EPERM: o processo existe, só não é nosso
+    if (pid > 0 && kill(pid, 0) == -1 && errno == ESRCH) pid = 0;
+    return pid;
+}
+
+} // namespace
+
+SharedFleetWriter::SharedFleetWriter()
+    : base(nullptr), size(0), header(nullptr), slots(nullptr) {}
+
+SharedFleetWriter::~SharedFleetWriter() {
+    this->close();
+}
+
+bool SharedFleetWriter::create(const std::string& name, uint32_t meterCount, uint32_t tickPeriodUs) {
+    this->close();
+
+    size_t totalSize = sizeof(SharedFleetHeader) + static_cast<size_t>(meterCount) * sizeof(SharedMeterSlot);
+
+    // Só remove segmento antigo de execução interrompida; outro simulador
+    // publicando no mesmo nome continua com o seu
+    pid_t owner = liveWriter(name);
+    if (owner != 0) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] SharedFleetWriter::create - " + name +
+                    " em uso pelo processo " + std::to_string(owner));
+        return false;
+    }
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd == -1) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] SharedFleetWriter::create - shm_open falhou para " + name + ": " + strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(totalSize)) == -1) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] SharedFleetWriter::create - ftruncate falhou: " + std::string(strerror(errno)));
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* mem = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] SharedFleetWriter::create - mmap falhou: " + std::string(strerror(errno)));
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    this->name = name;
+    this->base = mem;
+    this->size = totalSize;
+    this->header = new (mem) SharedFleetHeader();
+    this->slots = reinterpret_cast<SharedMeterSlot*>(static_cast<char*>(mem) + sizeof(SharedFleetHeader));
+    for (uint32_t i = 0; i < meterCount; ++i) {
+        new (&this->slots[i]) SharedMeterSlot();
+    }
+
+    this->header->magic = SHARED_FLEET_MAGIC;
+    this->header->versionMajor = SHARED_FLEET_VERSION_MAJOR;
+    this->header->versionMinor = SHARED_FLEET_VERSION_MINOR;
+    this->header->headerSize = sizeof(SharedFleetHeader);
+    this->header->slotSize = sizeof(SharedMeterSlot);
+    this->header->meterCount = meterCount;
+    this->header->tickPeriodUs = tickPeriodUs;
+    this->header->writerPid = static_cast<uint32_t>(getpid());
+    this->header->generation = static_cast<uint64_t>(
+        std::chrono::system_clock::now().time_since_epoch().count());
+    // Publica o cabeçalho completo antes de sinalizar o segmento como ativo
+    this->header->state.store(static_cast<uint32_t>(SharedFleetState::ACTIVE), std::memory_order_release);
+
+    Logger::log(LogLevel::DEBUG, "[DEBUG] SharedFleetWriter::create - Segmento " + name + " criado com " +
+                std::to_string(meterCount) + " slots (" + std::to_string(totalSize) + " bytes)");
+    return true;
+}
+
+void SharedFleetWriter::close() {
+    if (!this->base) return;
+
+    this->header->state.store(static_cast<uint32_t>(SharedFleetState::CLOSED), std::memory_order_release);
+    munmap(this->base, this->size);
+    // Leitores que já mapearam o segmento continuam com acesso até desmapearem
+    shm_unlink(this->name.c_str());
+
+    this->base = nullptr;
+    this->size = 0;
+    this->header = nullptr;
+    this->slots = nullptr;
+}
+
+SharedMeterSlot* SharedFleetWriter::getSlot(uint32_t index) const {
+    if (!this->header || index >= this->header->meterCount) return nullptr;
+    return &this->slots[index];
+}
+
+uint32_t SharedFleetWriter::getMeterCount() const { return this->header ? this->header->meterCount : 0; }
+bool SharedFleetWriter::isOpen() const { return this->base != nullptr; }
+
+SharedFleetReader::SharedFleetReader()
+    : base(nullptr), size(0), header(nullptr), slots(nullptr) {}
+
+SharedFleetReader::~SharedFleetReader() {
+    this->close();
+}
+
+bool SharedFleetReader::open(const std::string& name) {
+    this->close();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(SharedFleetHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mem = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) return false;
+
+    const SharedFleetHeader* hdr = static_cast<const SharedFleetHeader*>(mem);
+    size_t expected = hdr->headerSize + static_cast<size_t>(hdr->meterCount) * hdr->slotSize;
+    if (hdr->magic != SHARED_FLEET_MAGIC || hdr->versionMajor != SHARED_FLEET_VERSION_MAJOR ||
+        hdr->slotSize != sizeof(SharedMeterSlot) || hdr->headerSize != sizeof(SharedFleetHeader) ||
+        expected > static_cast<size_t>(st.st_size)) {
+        munmap(mem, st.st_size);
+        return false;
+    }
+
+    this->base = mem;
+    this->size = st.st_size;
+    this->header = hdr;
+    this->slots = reinterpret_cast<const SharedMeterSlot*>(static_cast<const char*>(mem) + hdr->headerSize);
+    return true;
+}
+
+void SharedFleetReader::close() {
+    if (!this->base) return;
+    munmap(this->base, this->size);
+    this->base = nullptr;
+    this->size = 0;
+    this->header = nullptr;
+    this->slots = nullptr;
+}
+
+uint32_t SharedFleetReader::getMeterCount() const { return this->header ? this->header->meterCount : 0; }
+uint64_t SharedFleetReader::getGeneration() const { return this->header ? this->header->generation : 0; }
+
+SharedFleetState SharedFleetReader::getState() const {
+    if (!this->header) return SharedFleetState::CLOSED;
+    return static_cast<SharedFleetState>(this->header->state.load(std::memory_order_acquire));
+}
+
+bool SharedFleetReader::read(uint32_t index, SharedMeterRecord& out, uint32_t* version) const {
+    if (!this->header || index >= this->header->meterCount) return false;
+    out = this->slots[index].record.load(version);
+    return true;
+}
@@ -0,0 +1,134 @@
+#ifndef SHARED_FLEET_H
+#define SHARED_FLEET_H
+
+#include "../utils/seqlock.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Estado vivo da frota publicado em memória compartilhada POSIX (shm_open).
+//
+// Layout versão 1.1 (little-endian, offsets em bytes):
+//
+//   Cabeçalho (64 bytes, offset 0)
+//     +0   uint32  magic          0x52445948 ("HYDR")
+//     +4   uint16  versionMajor   1 (muda em alterações incompatíveis)
+//     +6   uint16  versionMinor   1 (campos novos em espaço reservado)
+//     +8   uint32  headerSize     64
+//     +12  uint32  slotSize       64
+//     +16  uint32  meterCount     número de slots
+//     +20  uint32  tickPeriodUs   período nominal de atualização (µs)
+//     +24  uint64  generation     muda a cada (re)criação do segmento
+//     +32  uint32  state          0 = inicializando, 1 = ativo, 2 = encerrado
+//     +36  uint32  writerPid      processo escritor (1.1; 0 em segmentos 1.0)
+//     +40  ...     reservado
+//
+//   Slots (meterCount x 64 bytes, offset 64 + i * 64), um por hidrômetro
+//     +0   uint32  seq            seqlock: ímpar = escrita em curso
+//     +4   uint32  id
+//     +8   uint32  status         1 = ativo
+//     +12  float32 flowIN         m³/s
+//     +16  float32 flowOUT        m³/s
+//     +20  int32   counter        litros
+//     +24  float32 maxFlow        m³/s
+//     +28  uint32  ticks          atualizações publicadas
+//     +32  ...     reservado
+//
+// Leitura consistente de um slot (sem syscalls nem locks): ler seq (acquire);
+// se ímpar, repetir; copiar o payload; ler seq de novo; se mudou, repetir.
+// Cada slot ocupa uma linha de cache, então escritores de hidrômetros
+// diferentes não disputam a mesma linha.
+
+#define SHARED_FLEET_MAGIC 0x52445948u
+#define SHARED_FLEET_VERSION_MAJOR 1
+#define SHARED_FLEET_VERSION_MINOR 1
+#define SHARED_FLEET_DEFAULT_NAME "/hydrometer_fleet"
+
+enum class SharedFleetState : uint32_t {
+    INITIALIZING = 0,
+    ACTIVE = 1,
+    CLOSED = 2
+};
+
+struct SharedMeterRecord {
+    uint32_t id;
+    uint32_t status;
+    float flowIN;
+    float flowOUT;
+    int32_t counter;
+    float maxFlow;
+    uint32_t ticks;
+};
+
+struct alignas(64) SharedMeterSlot {
+    SeqLock<SharedMeterRecord> record;
+};
+
+struct alignas(64) SharedFleetHeader {
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    uint32_t headerSize;
+    uint32_t slotSize;
+    uint32_t meterCount;
+    uint32_t tickPeriodUs;
+    uint64_t generation;
+    std::atomic<uint32_t> state;
+    uint32_t writerPid;
+};
+
+static_assert(sizeof(SharedFleetHeader) == 64, "layout do cabeçalho mudou");
+static_assert(sizeof(SharedMeterSlot) == 64, "layout do slot mudou");
+static_assert(offsetof(SharedFleetHeader, generation) == 24, "layout do cabeçalho mudou");
+static_assert(offsetof(SharedFleetHeader, state) == 32, "layout do cabeçalho mudou");
+static_assert(offsetof(SharedFleetHeader, writerPid) == 36, "layout do cabeçalho mudou");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock entre processos requer atomics lock-free");
+
+// Lado do simulador: cria o segmento e publica os slots. Um segmento de mesmo
+// nome deixado por uma execução interrompida (encerrado ou de escritor que
+// não existe mais) é substituído; create() falha se o escritor ainda vive.
+class SharedFleetWriter {
+public:
+    SharedFleetWriter();
+    ~SharedFleetWriter();
+
+    bool create(const std::string& name, uint32_t meterCount, uint32_t tickPeriodUs);
+    void close();
+
+    SharedMeterSlot* getSlot(uint32_t index) const;
+    uint32_t getMeterCount() const;
+    bool isOpen() const;
+
+private:
+    std::string name;
+    void* base;
+    size_t size;
+    SharedFleetHeader* header;
+    SharedMeterSlot* slots;
+};
+
+// Lado dos consumidores externos: mapeia somente leitura
+class SharedFleetReader {
+public:
+    SharedFleetReader();
+    ~SharedFleetReader();
+
+    bool open(const std::string& name);
+    void close();
+
+    uint32_t getMeterCount() const;
+    uint64_t getGeneration() const;
+    SharedFleetState getState() const;
+
+    // Cópia consistente do slot index; false se o índice for inválido
+    bool read(uint32_t index, SharedMeterRecord& out, uint32_t* version = nullptr) const;
+
+private:
+    void* base;
+    size_t size;
+    const SharedFleetHeader* header;
+    const SharedMeterSlot* slots;
+};
+
+#endif // SHARED_FLEET_H
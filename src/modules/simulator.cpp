@@ -1,5 +1,6 @@
 #include "simulator.hpp"
 #include "../utils/logger.hpp"
+#include <poll.h>
 
     int Simulator::getKey() const {
         struct termios oldt, newt;
@@ -53,6 +54,13 @@
         return ch;
     }
 
+    void Simulator::displaySnapshot() const {
+        // Status, vazões e contador vêm do mesmo tick (snapshot consistente)
+        int id = this->atual.load();
+        MeterSnapshot snap = this->hidrometer[id].getSnapshot();
+        Logger::logRuntime(snap.status ? "ATIVO" : "INATIVO", snap.flowIN, snap.flowOUT, snap.counter, id);
+    }
+
     void Simulator::updateFlow(){
         int input;
         float maxFlow;
@@ -63,24 +71,27 @@
         tcflush(STDIN_FILENO, TCIFLUSH);
 
         int iteration = 0;
-        while (this->running.load()) {
+        bool keyReady = false;
+        while (!this->stopSignal.stopRequested()) {
             iteration++;
-            input = this->getKey();
+            input = keyReady ? this->getKey() : 0;
             
-            // Se não há entrada, aguarda um pouco antes de verificar novamente
+            // Se não há entrada, espera por tecla ou parada (display a cada 50ms)
             if (input == 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                if (keyReady) {
+                    // stdin legível sem tecla (EOF): não há o que esperar no poll
+                    this->stopSignal.waitFor(std::chrono::milliseconds(50));
+                    keyReady = false;
+                } else {
+                    struct pollfd fds[2] = {{STDIN_FILENO, POLLIN, 0}, {this->stopSignal.fd(), POLLIN, 0}};
+                    keyReady = poll(fds, 2, 50) > 0 && (fds[0].revents & POLLIN);
+                }
                 
                 // Atualiza display mesmo sem entrada
-                Logger::logRuntime(
-                    this->hidrometer[atual].getStatus() ? "ATIVO" : "INATIVO",
-                    this->hidrometer[atual].getPipeIN()->getFlowRate(),
-                    this->hidrometer[atual].getPipeOUT()->getFlowRate(),
-                    this->hidrometer[atual].getCounter(),
-                    atual
-                );
+                if (!keyReady) this->displaySnapshot();
                 continue;
             }
+            keyReady = false;
             
             switch (input) {
                 case KEY_UP:
@@ -91,6 +102,7 @@
                     currentFlow = this->hidrometer[atual].getPipeIN()->getFlowRate();
                     chunks = maxFlow / 50.0f;
                     this->hidrometer[atual].getPipeIN()->setFlowRate(currentFlow + chunks);
+                    this->hidrometer[atual].notifyControl();
                     tcflush(STDIN_FILENO, TCIFLUSH);
                     break;
 
@@ -102,12 +114,13 @@
                     currentFlow = this->hidrometer[atual].getPipeIN()->getFlowRate();
                     chunks = maxFlow / 50.0f;
                     this->hidrometer[atual].getPipeIN()->setFlowRate(currentFlow - chunks);
+                    this->hidrometer[atual].notifyControl();
                     tcflush(STDIN_FILENO, TCIFLUSH); // Limpa buffer
                     break;
 
                 case KEY_ESC: // ESC
                     Logger::log(LogLevel::SHUTDOWN, "[INFO] Saída solicitada pelo usuário");
-                    this->running.store(false);
+                    this->stopSignal.requestStop();
                     tcflush(STDIN_FILENO, TCIFLUSH);
                     break;
                 default:
@@ -116,18 +129,13 @@
             }
         
             // Atualiza display após processar comando
-            Logger::logRuntime(
-                this->hidrometer[atual].getStatus() ? "ATIVO" : "INATIVO",
-                this->hidrometer[atual].getPipeIN()->getFlowRate(),
-                this->hidrometer[atual].getPipeOUT()->getFlowRate(),
-                this->hidrometer[atual].getCounter(),
-                atual
-            );
+            this->displaySnapshot();
         }
         Logger::log(LogLevel::SHUTDOWN, "[DEBUG] Simulator::updateFlow - Thread de controle finalizada após " + std::to_string(iteration) + " iterações");
     }
 
-    Simulator::Simulator() {
+    // Todos os hidrômetros do simulador pertencem a uma única região (grupo 0)
+    Simulator::Simulator() : analytics(MAX_SIM), rollup(std::vector<uint32_t>(MAX_SIM, 0), 1) {
         this->running.store(false);
         
         // Hidrômetro residencial padrão com dimensões realísticas:
@@ -147,7 +155,59 @@
     Pipe* Simulator::getPipeOUT() const { return this->hidrometer[atual].getPipeOUT(); }
     int Simulator::getCounter() const { return this->hidrometer[atual].getCounter(); }
     bool Simulator::getHidrometerStatus() const { return this->hidrometer[atual].getStatus(); }
-    bool Simulator::isRunning() const { return this->running.load(); }
+    MeterSnapshot Simulator::getSnapshot(int id) const { return this->hidrometer[id].getSnapshot(); }
+    bool Simulator::isRunning() const { return this->running.load() && !this->stopSignal.stopRequested(); }
+    int Simulator::getStopFd() const { return this->stopSignal.fd(); }
+
+    bool Simulator::enableSharedState(const std::string& name) {
+        // Período nominal de atualização dos hidrômetros: 100ms
+        if (!this->sharedFleet.create(name, MAX_SIM, 100000)) {
+            return false;
+        }
+        for (size_t i = 0; i < MAX_SIM; i++)
+        {
+            this->hidrometer[i].attachSharedSlot(this->sharedFleet.getSlot(i), i);
+        }
+        Logger::log(LogLevel::STARTUP, "[INFO] Estado da frota publicado em memória compartilhada: " + name);
+        return true;
+    }
+
+    void Simulator::setAffinity(const ThreadAffinity& affinity) { this->affinity = affinity; }
+
+    TickHistogram Simulator::getTickHistogram() const {
+        TickHistogram total;
+        for (size_t i = 0; i < MAX_SIM; i++)
+        {
+            total.merge(this->hidrometer[i].getTickHistogram());
+        }
+        return total;
+    }
+
+    bool Simulator::enableImageService(const std::string& path) {
+        auto provider = [this](uint32_t meter, MeterSnapshot& snapshot, float& maxFlow) {
+            if (meter >= MAX_SIM) return false;
+            snapshot = this->hidrometer[meter].getSnapshot();
+            maxFlow = this->hidrometer[meter].getPipeIN()->getMaxFlow();
+            return true;
+        };
+        auto service = std::make_unique<ImageService>(provider);
+        if (!service->start(path)) {
+            return false;
+        }
+        this->imageService = std::move(service);
+        Logger::log(LogLevel::STARTUP, "[INFO] Imagens dos hidrômetros disponíveis no socket: " + path);
+        return true;
+    }
+
+    bool Simulator::getConsumption(int meter, int64_t from, int64_t to, int64_t& liters) const {
+        std::lock_guard<std::mutex> lock(this->rollupMutex);
+        return this->rollup.meterConsumption(meter, from, to, liters);
+    }
+
+    std::vector<std::pair<uint32_t, int64_t>> Simulator::getTopConsumers(size_t k, int64_t from, int64_t to) const {
+        std::lock_guard<std::mutex> lock(this->rollupMutex);
+        return this->rollup.topConsumers(k, from, to);
+    }
 
     void Simulator::run() {
         this->running.store(true);
@@ -157,6 +217,17 @@
         }
         this->inputThread = std::thread(&Simulator::updateFlow, this);
         this->imageThread = std::thread(&Simulator::imageUpdateLoop, this);
+        this->analyticsThread = std::thread(&Simulator::analyticsLoop, this);
+
+        for (size_t i = 0; i < MAX_SIM; i++)
+        {
+            this->hidrometer[i].pinTo(this->affinity.tick);
+        }
+        pinThread(this->imageThread, this->affinity.render);
+        if (this->imageService) {
+            this->imageService->pinTo(this->affinity.render);
+        }
+        pinThread(this->inputThread, this->affinity.input);
     }
 
     void Simulator::stop() {
@@ -169,7 +240,12 @@
         
         Logger::log(LogLevel::SHUTDOWN, "[INFO] Parando hidrômetros...");
         
-        // Para completamente os hidrômetros (finaliza threads internas)
+        // Acorda todas as esperas de uma vez; os joins abaixo não esperam períodos
+        this->stopSignal.requestStop();
+        for (size_t i = 0; i < MAX_SIM; i++)
+        {
+            this->hidrometer[i].requestShutdown();
+        }
         for (size_t i = 0; i < MAX_SIM; i++)
         {
             this->hidrometer[i].shutdown();
@@ -188,6 +264,18 @@
         
         waitForThread(inputThread, "inputThread");
         waitForThread(imageThread, "imageThread");
+        waitForThread(analyticsThread, "analyticsThread");
+
+        if (this->imageService) {
+            this->imageService->stop();
+        }
+
+        // Threads dos hidrômetros já finalizadas: nenhum escritor no segmento
+        for (size_t i = 0; i < MAX_SIM; i++)
+        {
+            this->hidrometer[i].attachSharedSlot(nullptr, i);
+        }
+        this->sharedFleet.close();
 
         // Restaura configurações do terminal
         struct termios term;
@@ -203,17 +291,17 @@
         
         int nextImageThreshold[MAX_SIM] = {0}; // Próximo marco para gerar imagem (em litros = 1m³)
 
-        while (this->running.load()) {
+        while (!this->stopSignal.stopRequested()) {
             updateCount++;
             
             for (size_t i = 0; i < MAX_SIM; i++){
-                int currentCounter = this->hidrometer[i].getCounter();
+                MeterSnapshot snap = this->hidrometer[i].getSnapshot();
             
                 try {
                     // Verifica se atingiu o próximo marco (10L para testes)
-                    if (currentCounter >= nextImageThreshold[i]) {
-                        int counter = this->hidrometer[i].getCounter();
-                        float flowRate = this->hidrometer[i].getPipeIN()->getFlowRate();
+                    if (snap.counter >= nextImageThreshold[i]) {
+                        int counter = snap.counter;
+                        float flowRate = snap.flowIN;
 
                         Logger::log(LogLevel::DEBUG, "[DEBUG] Simulator::imageUpdateLoop - Update #" + 
                                 std::to_string(updateCount) + " - Counter: " + std::to_string(counter) + 
@@ -238,9 +326,57 @@
                 }
             }
             
-            // Sempre aguarda antes de verificar novamente (evita loop muito rápido)
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            // Aguarda antes de verificar novamente; a parada interrompe a espera
+            this->stopSignal.waitFor(std::chrono::milliseconds(500));
         }
         
         Logger::log(LogLevel::SHUTDOWN, "[DEBUG] Simulator::imageUpdateLoop - Thread de geração de imagens finalizada");
-    }
\ No newline at end of file
+    }
+
+    void Simulator::analyticsLoop() {
+        std::vector<float> flowIN(MAX_SIM);
+        std::vector<float> flowOUT(MAX_SIM);
+        std::vector<int32_t> counter(MAX_SIM);
+        std::vector<AnalyticsAlert> alerts;
+        auto last = std::chrono::steady_clock::now();
+
+        while (this->stopSignal.waitFor(std::chrono::milliseconds(100)) != StopSignal::Wake::STOPPED) {
+
+            auto now = std::chrono::steady_clock::now();
+            float dt = std::chrono::duration<float>(now - last).count();
+            last = now;
+
+            // Amostra a frota em arrays SoA para o kernel de análise
+            for (size_t i = 0; i < MAX_SIM; i++) {
+                MeterSnapshot snap = this->hidrometer[i].getSnapshot();
+                flowIN[i] = snap.flowIN;
+                flowOUT[i] = snap.flowOUT;
+                counter[i] = snap.counter;
+            }
+
+            // Janela noturna baseada no horário local
+            time_t wall = time(nullptr);
+            struct tm local;
+            localtime_r(&wall, &local);
+            float secondsOfDay = local.tm_hour * 3600.0f + local.tm_min * 60.0f + local.tm_sec;
+
+            alerts.clear();
+            this->analytics.tick(flowIN.data(), flowOUT.data(), counter.data(), dt, secondsOfDay, alerts);
+
+            {
+                // Agregação por hora/dia/mês a partir do avanço dos contadores
+                std::lock_guard<std::mutex> lock(this->rollupMutex);
+                this->rollup.recordAll(counter.data(), static_cast<int64_t>(wall));
+            }
+
+            for (const AnalyticsAlert& alert : alerts) {
+                std::ostringstream text;
+                text << "[ALERTA] Hidrômetro " << alert.meter << ": " << FleetAnalytics::alertName(alert.type)
+                     << " (" << std::fixed << std::setprecision(4) << alert.value << ")";
+                Logger::log(LogLevel::DEBUG, "[DEBUG] Simulator::analyticsLoop - " + text.str());
+                Logger::setRuntimeAlert(text.str());
+            }
+        }
+
+        Logger::log(LogLevel::SHUTDOWN, "[DEBUG] Simulator::analyticsLoop - Thread de análise finalizada");
+    }
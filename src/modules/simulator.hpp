@@ -4,15 +4,26 @@
 #include <thread>
 #include <memory>
 #include <atomic>
+#include <mutex>
 #include <random>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <vector>
+#include <ctime>
 #include <unistd.h>
 #include <fcntl.h>
 #include <termios.h>
 #include "hidrometer.hpp"
+#include "shared_fleet.hpp"
+#include "analytics.hpp"
+#include "rollup.hpp"
+#include "image_service.hpp"
 #include "../utils/image.hpp"
+#include "../utils/stop_signal.hpp"
+#include "../utils/cpu_affinity.hpp"
+#include "../utils/tick_clock.hpp"
 
 #define IMAGE_PATH "medicoes_202311250013/"
 #define MAX_SIM 5
@@ -34,7 +45,24 @@ class Simulator {
         Pipe* getPipeOUT() const;
         int getCounter() const;
         bool getHidrometerStatus() const;
+        MeterSnapshot getSnapshot(int id) const;
         bool isRunning() const;
+        // eventfd legível quando a simulação termina (ESC ou stop()), para poll()
+        int getStopFd() const;
+
+        // Publica o estado da frota em memória compartilhada (chamar antes de run())
+        bool enableSharedState(const std::string& name = SHARED_FLEET_DEFAULT_NAME);
+        // Serve a imagem atual de cada hidrômetro por socket Unix (ver ImageService)
+        bool enableImageService(const std::string& path = IMAGE_SERVICE_DEFAULT_PATH);
+
+        // CPUs das threads de tick, render e entrada (aplicadas em run())
+        void setAffinity(const ThreadAffinity& affinity);
+        // Atraso dos ticks de todos os hidrômetros em relação aos prazos
+        TickHistogram getTickHistogram() const;
+
+        // Consultas de consumo agregado (litros) sobre janelas [from, to) em segundos Unix
+        bool getConsumption(int meter, int64_t from, int64_t to, int64_t& liters) const;
+        std::vector<std::pair<uint32_t, int64_t>> getTopConsumers(size_t k, int64_t from, int64_t to) const;
 
         void run();
         void stop();
@@ -43,15 +71,29 @@ class Simulator {
     private:
         int getKey() const;
         void updateFlow();
+        void displaySnapshot() const;
         void updateImage() const;
         void imageUpdateLoop() const;
+        void analyticsLoop();
 
         std::atomic<bool> running;
+        // Parada compartilhada pelos laços do simulador (ESC, stop() ou Ctrl+C)
+        mutable StopSignal stopSignal;
+        // Declarado antes dos hidrômetros: o segmento só é desmapeado depois
+        // que as threads de atualização (escritoras) terminam
+        SharedFleetWriter sharedFleet;
         std::unique_ptr<Hidrometer[]> hidrometer;
         std::thread inputThread;
         std::thread imageThread;
+        std::thread analyticsThread;
         std::atomic<int> atual;
+        ThreadAffinity affinity;
         Image image;
+        FleetAnalytics analytics;
+        ConsumptionRollup rollup;
+        mutable std::mutex rollupMutex;
+        // Declarado depois dos hidrômetros: é destruído antes deles
+        std::unique_ptr<ImageService> imageService;
 };
 
 #endif // SIMULATOR_H
\ No newline at end of file
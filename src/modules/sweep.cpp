@@ -0,0 +1,271 @@
+#include "sweep.hpp"
+#include "fleet.hpp"
+#include "../utils/stop_signal.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+const float TICK_SECONDS = 0.1f;      // passo assumido por Hidrometer::update
+const int IMAGE_CHECK_TICKS = 5;      // imageUpdateLoop verifica a cada 500 ms
+const int IMAGE_STEP_LITERS = 10;     // marco entre imagens
+const int FLOW_CHUNKS = 50;           // passos das setas no Simulator
+
+// Semente independente por cenário (splitmix64 de seed e índice)
+uint64_t scenarioSeed(uint64_t seed, uint32_t index) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * (static_cast<uint64_t>(index) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Estado do cenário por hidrômetro; vazões e contador ficam no GeometryBatch
+struct ScenarioMeter {
+    int32_t nextImage;
+    double nextEvent;     // próxima manobra (s virtuais)
+    double litersIn;      // volumes reais, integrados com o intervalo real do tick
+    double litersOut;
+    double tickSeconds;   // duração real do tick corrente
+};
+
+void appendStats(std::ostringstream& s, const char* name, const RunningStats& stats, const std::string& extra = "") {
+    s << "\"" << name << "\":{\"mean\":" << stats.mean << ",\"std\":" << stats.stddev()
+      << ",\"min\":" << stats.min << ",\"max\":" << stats.max << extra << "}";
+}
+
+double percentile(std::vector<double>& values, double q) {
+    if (values.empty()) return 0.0;
+    size_t k = static_cast<size_t>(q * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+} // namespace
+
+void RunningStats::add(double value) {
+    ++this->count;
+    if (this->count == 1) {
+        this->min = value;
+        this->max = value;
+    } else {
+        this->min = std::min(this->min, value);
+        this->max = std::max(this->max, value);
+    }
+    double delta = value - this->mean;
+    this->mean += delta / this->count;
+    this->m2 += delta * (value - this->mean);
+}
+
+double RunningStats::stddev() const {
+    return this->count > 1 ? std::sqrt(this->m2 / (this->count - 1)) : 0.0;
+}
+
+MonteCarloSweep::MonteCarloSweep(const SweepConfig& config)
+    : config(config),
+      scenariosPerSecond(0.0) {}
+
+ScenarioResult MonteCarloSweep::runScenario(uint32_t index) const {
+    std::mt19937_64 rng(scenarioSeed(this->config.seed, index));
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::exponential_distribution<double> interval(1.0 / this->config.demandInterval);
+
+    const MeterGeometry& nominal = Residential15::GEOMETRY;
+    const float tol = this->config.geometryTolerance;
+    auto perturb = [&](const PipeGeometry& pipe) {
+        PipeGeometry p = pipe;
+        p.length *= std::max(0.5f, 1.0f + tol * normal(rng));
+        p.diameter *= std::max(0.5f, 1.0f + tol * normal(rng));
+        return p;
+    };
+
+    // Hidrômetros de tubos perturbados no lote de geometrias: as regras de
+    // Pipe::setFlowRate e Hidrometer::update são as da frota em lote
+    GeometryBatch batch;
+    std::vector<ScenarioMeter> meters(this->config.metersPerScenario);
+    batch.reserve(meters.size());
+    for (ScenarioMeter& m : meters) {
+        PipeGeometry in = perturb(nominal.in);
+        PipeGeometry out = perturb(nominal.out);
+        uint16_t geometry = 0;
+        batch.registerGeometry(in, out, geometry);
+        batch.add(geometry, 0, true);
+        m.nextImage = 0;
+        m.nextEvent = interval(rng);
+        m.litersIn = 0.0;
+        m.litersOut = 0.0;
+        m.tickSeconds = TICK_SECONDS;
+    }
+
+    ScenarioResult result = {0.0, 0.0, 0.0, 0.0};
+    const float chunk = nominal.in.maxFlow / FLOW_CHUNKS;
+    const int maxChunks = static_cast<int>(this->config.demandPeak * FLOW_CHUNKS);
+    const bool jitter = this->config.tickJitter > 0.0f;
+    const uint64_t ticks = static_cast<uint64_t>(this->config.virtualSeconds / TICK_SECONDS);
+    double now = 0.0;
+
+    for (uint64_t t = 1; t <= ticks; ++t) {
+        now += TICK_SECONDS;
+        bool imageCheck = (t % IMAGE_CHECK_TICKS) == 0;
+
+        for (uint32_t i = 0; i < meters.size(); ++i) {
+            ScenarioMeter& m = meters[i];
+            // Manobra do usuário: nova vazão em passos de maxFlow/50 (nominal)
+            if (now >= m.nextEvent) {
+                int k = uniform(rng) < this->config.idleProbability
+                      ? 0 : 1 + static_cast<int>(uniform(rng) * maxChunks);
+                if (!batch.setFlowRate(i, k * chunk)) result.rejectedSets += 1.0;
+                m.nextEvent = now + interval(rng);
+            }
+
+            // Duração real deste tick: 0.1 s +- jitter
+            m.tickSeconds = TICK_SECONDS;
+            if (jitter) m.tickSeconds *= std::max(0.0f, 1.0f + this->config.tickJitter * normal(rng));
+        }
+
+        // Hidrometer::update (o hidrômetro sempre assume 0.1 s)
+        batch.tick(TICK_SECONDS);
+
+        for (uint32_t i = 0; i < meters.size(); ++i) {
+            ScenarioMeter& m = meters[i];
+            MeterSnapshot snap = batch.getSnapshot(i);
+            m.litersIn += snap.flowIN * m.tickSeconds * 1000.0;
+            m.litersOut += snap.flowOUT * m.tickSeconds * 1000.0;
+
+            if (imageCheck && snap.counter >= m.nextImage) {
+                result.images += 1.0;
+                m.nextImage += IMAGE_STEP_LITERS;
+            }
+        }
+    }
+
+    double counted = 0.0, litersIn = 0.0, litersOut = 0.0;
+    for (uint32_t i = 0; i < meters.size(); ++i) {
+        const ScenarioMeter& m = meters[i];
+        counted += batch.getSnapshot(i).counter;
+        litersIn += m.litersIn;
+        litersOut += m.litersOut;
+    }
+    result.counterErrorPct = litersOut > 0.0 ? 100.0 * (counted - litersOut) / litersOut : 0.0;
+    result.lossRatio = litersIn > 0.0 ? 1.0 - litersOut / litersIn : 0.0;
+    return result;
+}
+
+bool MonteCarloSweep::run(std::ostream& out) {
+    if (this->config.scenarios == 0 || this->config.metersPerScenario == 0 || this->config.virtualSeconds <= 0.0) {
+        out << "{\"type\":\"error\",\"message\":\"configuração de varredura inválida\"}" << std::endl;
+        return false;
+    }
+
+    unsigned threads = this->config.threads ? this->config.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min(threads, this->config.scenarios));
+
+    this->results.assign(this->config.scenarios, ScenarioResult{0.0, 0.0, 0.0, 0.0});
+    std::atomic<uint32_t> next(0);
+    std::atomic<uint32_t> done(0);
+    StopSignal finished;   // o último cenário concluído acorda o relatório de progresso
+
+    // Estatísticas parciais para as linhas de progresso (ordem de conclusão)
+    std::mutex statsMutex;
+    RunningStats partial[4];
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned w = 0; w < threads; ++w) {
+        workers.emplace_back([&]() {
+            for (uint32_t i = next.fetch_add(1); i < this->config.scenarios; i = next.fetch_add(1)) {
+                ScenarioResult r = this->runScenario(i);
+                this->results[i] = r;
+                {
+                    std::lock_guard<std::mutex> lock(statsMutex);
+                    partial[0].add(r.counterErrorPct);
+                    partial[1].add(r.lossRatio);
+                    partial[2].add(r.images);
+                    partial[3].add(r.rejectedSets);
+                }
+                if (done.fetch_add(1, std::memory_order_release) + 1 == this->config.scenarios) finished.requestStop();
+            }
+        });
+    }
+
+    out << std::setprecision(9);
+    auto elapsedSince = [&start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // Uma linha a cada progressSeconds (no mínimo 20 ms) até o último cenário
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(std::max(0.02, this->config.progressSeconds)));
+    auto nextReport = start + period;
+    while (finished.waitUntil(nextReport) != StopSignal::Wake::STOPPED) {
+        double elapsed = elapsedSince();
+        nextReport = std::chrono::steady_clock::now() + period;
+
+        std::ostringstream line;
+        line << std::setprecision(9);
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            line << "{\"type\":\"progress\",\"done\":" << partial[0].count
+                 << ",\"total\":" << this->config.scenarios
+                 << ",\"elapsed_s\":" << elapsed
+                 << ",\"scenarios_per_s\":" << partial[0].count / elapsed << ",";
+            appendStats(line, "counter_error_pct", partial[0]);
+            line << ",";
+            appendStats(line, "loss_ratio", partial[1]);
+            line << ",";
+            appendStats(line, "images", partial[2]);
+            line << "}";
+        }
+        out << line.str() << std::endl;
+    }
+
+    for (std::thread& t : workers) t.join();
+    double elapsed = elapsedSince();
+    this->scenariosPerSecond = this->config.scenarios / elapsed;
+
+    // Resumo reduzido na ordem dos índices: independe do número de threads
+    RunningStats total[4];
+    std::vector<double> values[4];
+    for (int k = 0; k < 4; ++k) values[k].reserve(this->results.size());
+    for (const ScenarioResult& r : this->results) {
+        const double metrics[4] = {r.counterErrorPct, r.lossRatio, r.images, r.rejectedSets};
+        for (int k = 0; k < 4; ++k) {
+            total[k].add(metrics[k]);
+            values[k].push_back(metrics[k]);
+        }
+    }
+
+    const char* names[4] = {"counter_error_pct", "loss_ratio", "images", "rejected_sets"};
+    std::ostringstream line;
+    line << std::setprecision(9);
+    line << "{\"type\":\"summary\",\"scenarios\":" << this->config.scenarios
+         << ",\"meters_per_scenario\":" << this->config.metersPerScenario
+         << ",\"virtual_seconds\":" << this->config.virtualSeconds
+         << ",\"seed\":" << this->config.seed
+         << ",\"threads\":" << threads
+         << ",\"elapsed_s\":" << elapsed
+         << ",\"scenarios_per_s\":" << this->scenariosPerSecond;
+    for (int k = 0; k < 4; ++k) {
+        line << ",";
+        std::ostringstream quantiles;
+        quantiles << std::setprecision(9)
+                  << ",\"p05\":" << percentile(values[k], 0.05)
+                  << ",\"p50\":" << percentile(values[k], 0.50)
+                  << ",\"p95\":" << percentile(values[k], 0.95);
+        appendStats(line, names[k], total[k], quantiles.str());
+    }
+    line << "}";
+    out << line.str() << std::endl;
+    return true;
+}
+
+const std::vector<ScenarioResult>& MonteCarloSweep::getResults() const { return this->results; }
+double MonteCarloSweep::getScenariosPerSecond() const { return this->scenariosPerSecond; }
@@ -0,0 +1,76 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Varredura Monte Carlo de cenários equivalentes ao Simulator, sem terminal,
+// sem threads por hidrômetro e em tempo virtual (sem sleeps).
+//
+// Cada cenário sorteia, a partir de um gerador próprio semeado por
+// (seed, índice), as tolerâncias de geometria dos tubos, o perfil de demanda
+// (manobras em passos de maxFlow/50, como as setas do Simulator) e o jitter
+// do tick, e integra os hidrômetros num GeometryBatch (mesmas regras de
+// solveMeterGeometry e do núcleo da frota, verificadas pelo EquivalenceChecker).
+// Os cenários são distribuídos entre threads de trabalho por um contador
+// atômico; o resultado de cada um depende só do seu índice, então o resumo
+// final é idêntico para qualquer número de threads.
+
+struct SweepConfig {
+    uint32_t scenarios = 1000;
+    uint32_t metersPerScenario = 5;     // MAX_SIM do Simulator
+    double virtualSeconds = 3600.0;     // duração simulada de cada cenário
+    uint64_t seed = 1;
+    unsigned threads = 0;               // 0 = todos os núcleos
+    float geometryTolerance = 0.02f;    // desvio-padrão relativo de diâmetro/comprimento
+    float demandPeak = 1.0f;            // demanda máxima como fração da vazão nominal
+    float demandInterval = 120.0f;      // intervalo médio entre manobras (s)
+    float idleProbability = 0.3f;       // chance de uma manobra fechar o consumo
+    float tickJitter = 0.05f;           // desvio-padrão relativo do intervalo real do tick
+    double progressSeconds = 1.0;       // intervalo entre linhas de progresso
+};
+
+// Métricas de um cenário (somadas sobre seus hidrômetros)
+struct ScenarioResult {
+    double counterErrorPct;   // (contador - volume OUT real) / volume OUT real, em %
+    double lossRatio;         // 1 - volume OUT / volume IN reais
+    double images;            // imagens que o imageUpdateLoop teria gerado (marcos de 10 L)
+    double rejectedSets;      // manobras recusadas por Pipe::setFlowRate (acima do máximo)
+};
+
+// Média/variância incremental (Welford) com mínimo e máximo
+struct RunningStats {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+
+    void add(double value);
+    double stddev() const;
+};
+
+class MonteCarloSweep {
+public:
+    explicit MonteCarloSweep(const SweepConfig& config);
+
+    // Executa todos os cenários; escreve linhas JSON de progresso durante a
+    // execução e uma linha de resumo ao final. false se a configuração é inválida.
+    bool run(std::ostream& out);
+
+    // Um cenário isolado (determinístico para (seed, index))
+    ScenarioResult runScenario(uint32_t index) const;
+
+    const std::vector<ScenarioResult>& getResults() const;
+    double getScenariosPerSecond() const;
+
+private:
+    SweepConfig config;
+    std::vector<ScenarioResult> results;
+    double scenariosPerSecond;
+};
+
+#endif // SWEEP_H
@@ -0,0 +1,68 @@
+#ifndef CONSTEXPR_MATH_H
+#define CONSTEXPR_MATH_H
+
+// Funções matemáticas avaliáveis em tempo de compilação (std::sqrt, std::log10
+// e std::pow não são constexpr). Precisão ~1e-15, suficiente para reproduzir
+// a solução iterativa de Pipe::maxFlowForDeltaP.
+namespace cmath {
+
+constexpr double LN2 = 0.693147180559945309417232121458;
+constexpr double LN10 = 2.30258509299404568401799145468;
+
+constexpr double abs(double x) { return x < 0.0 ? -x : x; }
+
+constexpr double sqrt(double x) {
+    if (x <= 0.0) return 0.0;
+    double r = x > 1.0 ? x : 1.0;
+    for (int i = 0; i < 200; ++i) {
+        double next = 0.5 * (r + x / r);
+        if (next == r) break;
+        r = next;
+    }
+    return r;
+}
+
+// ln(x) = k*ln2 + 2*atanh((m-1)/(m+1)), com m em [1, 2)
+constexpr double log(double x) {
+    if (x <= 0.0) return -1e308;
+    int k = 0;
+    while (x >= 2.0) { x *= 0.5; ++k; }
+    while (x < 1.0) { x *= 2.0; --k; }
+    double z = (x - 1.0) / (x + 1.0);
+    double z2 = z * z;
+    double term = z;
+    double sum = 0.0;
+    for (int n = 1; n < 200; n += 2) {
+        double add = term / n;
+        if (sum + add == sum) break;
+        sum += add;
+        term *= z2;
+    }
+    return k * LN2 + 2.0 * sum;
+}
+
+constexpr double log10(double x) { return log(x) / LN10; }
+
+// exp(x) = 2^k * exp(r), com |r| <= ln2/2
+constexpr double exp(double x) {
+    int k = static_cast<int>(x / LN2 + (x < 0.0 ? -0.5 : 0.5));
+    double r = x - k * LN2;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 60; ++n) {
+        term *= r / n;
+        if (sum + term == sum) break;
+        sum += term;
+    }
+    while (k > 0) { sum *= 2.0; --k; }
+    while (k < 0) { sum *= 0.5; ++k; }
+    return sum;
+}
+
+constexpr double pow(double base, double exponent) {
+    return base <= 0.0 ? 0.0 : exp(exponent * log(base));
+}
+
+} // namespace cmath
+
+#endif // CONSTEXPR_MATH_H
@@ -0,0 +1,72 @@
+#include "cpu_affinity.hpp"
+#include "logger.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+namespace {
+
+bool buildSet(const std::vector<int>& cpus, cpu_set_t& set) {
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+        CPU_SET(cpu, &set);
+    }
+    return true;
+}
+
+bool pinHandle(pthread_t handle, const std::vector<int>& cpus) {
+    if (cpus.empty()) return true;
+    cpu_set_t set;
+    if (!buildSet(cpus, set)) return false;
+    int error = pthread_setaffinity_np(handle, sizeof(set), &set);
+    if (error != 0) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] pinThread - Não foi possível fixar a thread nas CPUs " +
+                    formatCpuList(cpus) + ": " + strerror(error));
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    const char* p = text.c_str();
+    while (*p) {
+        char* end = nullptr;
+        long first = std::strtol(p, &end, 10);
+        if (end == p || first < 0 || first >= CPU_SETSIZE) return false;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            const char* start = ++p;
+            last = std::strtol(start, &end, 10);
+            if (end == start || last < first || last >= CPU_SETSIZE) return false;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(static_cast<int>(cpu));
+        if (*p == ',') ++p;
+        else if (*p) return false;
+    }
+    return !cpus.empty();
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::string text;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        if (i) text += ",";
+        text += std::to_string(cpus[i]);
+    }
+    return text;
+}
+
+bool pinThread(std::thread& thread, const std::vector<int>& cpus) {
+    return thread.joinable() && pinHandle(thread.native_handle(), cpus);
+}
+
+bool pinCurrentThread(const std::vector<int>& cpus) {
+    return pinHandle(pthread_self(), cpus);
+}
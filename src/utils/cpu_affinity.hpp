@@ -0,0 +1,25 @@
+#ifndef CPU_AFFINITY_H
+#define CPU_AFFINITY_H
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fixação de threads em CPUs escolhidas (sched_setaffinity).
+
+// Interpreta listas no formato do taskset/cpuset: "0", "0,2", "1-3,6"
+bool parseCpuList(const std::string& text, std::vector<int>& cpus);
+std::string formatCpuList(const std::vector<int>& cpus);
+
+// Lista vazia não altera a afinidade; false se o sistema recusar
+bool pinThread(std::thread& thread, const std::vector<int>& cpus);
+bool pinCurrentThread(const std::vector<int>& cpus);
+
+// CPUs de cada grupo de threads do simulador (vazio = sem fixação)
+struct ThreadAffinity {
+    std::vector<int> tick;     // threads de atualização dos hidrômetros
+    std::vector<int> render;   // geração de imagens e serviço de imagens
+    std::vector<int> input;    // thread de entrada (terminal)
+};
+
+#endif // CPU_AFFINITY_H
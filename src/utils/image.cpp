@@ -41,6 +41,24 @@ void Image::generate_image(int id, int counter, float flowRate, float maxFlowRat
     filename << "Hidrometro_" << id << "_" << (counter / 1000) << ".jpeg";
     std::string fullPath = outputPath + filename.str();
 
+    this->render(counter, flowRate, maxFlowRate);
+    this->save(fullPath);
+}
+
+void Image::save(const std::string& fullPath) const {
+    cairo_surface_write_to_png(this->surface, fullPath.c_str());
+}
+
+bool Image::encodePng(std::string& out) const {
+    out.clear();
+    auto append = [](void* closure, const unsigned char* data, unsigned int length) -> cairo_status_t {
+        static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+        return CAIRO_STATUS_SUCCESS;
+    };
+    return cairo_surface_write_to_png_stream(this->surface, append, &out) == CAIRO_STATUS_SUCCESS;
+}
+
+void Image::render(int counter, float flowRate, float maxFlowRate) const {
     // Calcula escala dinâmica baseada na vazão máxima
     float maxFlowRate_m3h = maxFlowRate * 3600.0f; // Converte para m³/h
     // Arredonda para cima para o próximo múltiplo de 5 para uma escala limpa
@@ -294,7 +312,4 @@ void Image::generate_image(int id, int counter, float flowRate, float maxFlowRat
     cairo_text_extents(this->cr, title, &titleExtents);
     cairo_move_to(this->cr, centerX - titleExtents.width/2, 30);
     cairo_show_text(this->cr, title);
-
-    // Salva a imagem
-    cairo_surface_write_to_png(this->surface, fullPath.c_str());
 }
@@ -14,6 +14,12 @@ public:
     ~Image();
     void generate_image(int id, int counter, float flowRate, float maxFlowRate, std::string outputPath) const;
 
+    // Etapas separadas de generate_image: desenho do mostrador e gravação do PNG
+    void render(int counter, float flowRate, float maxFlowRate) const;
+    void save(const std::string& fullPath) const;
+    // Codifica o último render em PNG na memória (sem arquivo); false se o cairo falhar
+    bool encodePng(std::string& out) const;
+
 private:
     cairo_surface_t* surface;
     cairo_t* cr;
@@ -2,6 +2,8 @@
 
 bool Logger::showDebug = false;
 bool Logger::runtimeStarted = false;
+std::string Logger::runtimeAlert;
+std::mutex Logger::alertMutex;
 
 void Logger::setDebugMode(bool enabled) {
     showDebug = enabled;
@@ -52,9 +54,20 @@ void Logger::logRuntime(const std::string& status, float flowIN, float flowOUT,
     std::cout << "│ Vazão IN: " << std::fixed << std::setprecision(2) << std::setw(8) << flowIN_m3h 
               << " m³/h │ Vazão OUT: " << std::setw(8) << flowOUT_m3h << " m³/h      │" << std::endl;
     std::cout << "└─────────────────────────────────────────────────────────┘" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(alertMutex);
+        if (!runtimeAlert.empty()) {
+            std::cout << runtimeAlert << std::endl;
+        }
+    }
     std::cout << std::flush;
 }
 
+void Logger::setRuntimeAlert(const std::string& alert) {
+    std::lock_guard<std::mutex> lock(alertMutex);
+    runtimeAlert = alert;
+}
+
 void Logger::clearRuntimeArea() {
     // Limpa a tela completamente
     std::cout << "\033[2J\033[H" << std::flush;
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 #include <string>
 
 enum class LogLevel {
@@ -16,6 +17,8 @@ class Logger {
 private:
     static bool showDebug;
     static bool runtimeStarted;
+    static std::string runtimeAlert;
+    static std::mutex alertMutex;
 
 public:
     static void setDebugMode(bool enabled);
@@ -24,6 +27,8 @@ public:
     static void log(LogLevel level, const std::string& message);
     static void logRuntime(const std::string& status, float flowIN, float flowOUT, int newCounter, int hydrometerID);
     static void clearRuntimeArea();
+    // Linha de alerta exibida abaixo do painel runtime (vazio oculta)
+    static void setRuntimeAlert(const std::string& alert);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Seqlock de escritor único para valores pequenos e trivialmente copiáveis.
+//
+// O escritor nunca espera: incrementa a sequência (ímpar = escrita em curso),
+// grava o payload e incrementa de novo. Leitores não bloqueiam nem escrevem:
+// copiam o payload e repetem a leitura se a sequência mudou no meio.
+// O payload é guardado em palavras atômicas (acesso relaxed) para que a cópia
+// concorrente não seja uma data race, e o layout é fixo (sequência seguida das
+// palavras), o que permite usá-lo em memória compartilhada entre processos.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requer tipo trivialmente copiável");
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "SeqLock requer tamanho múltiplo de 4 bytes");
+
+public:
+    static constexpr size_t WORDS = sizeof(T) / sizeof(uint32_t);
+
+    SeqLock() : seq(0) {
+        for (size_t i = 0; i < WORDS; ++i) words[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Deve ser chamado por um único escritor
+    void store(const T& value) {
+        uint32_t raw[WORDS];
+        std::memcpy(raw, &value, sizeof(T));
+
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) words[i].store(raw[i], std::memory_order_relaxed);
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Uma tentativa de leitura; retorna false se coincidiu com uma escrita
+    bool tryLoad(T& out, uint32_t* version = nullptr) const {
+        uint32_t s1 = seq.load(std::memory_order_acquire);
+        if (s1 & 1u) return false;
+
+        uint32_t raw[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) raw[i] = words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (seq.load(std::memory_order_relaxed) != s1) return false;
+        std::memcpy(&out, raw, sizeof(T));
+        if (version) *version = s1 / 2;
+        return true;
+    }
+
+    // Repete até obter uma cópia consistente (a escrita é curta e sem bloqueio)
+    T load(uint32_t* version = nullptr) const {
+        T out;
+        while (!tryLoad(out, version)) {
+        }
+        return out;
+    }
+
+    // Número de escritas concluídas
+    uint32_t version() const { return seq.load(std::memory_order_acquire) / 2; }
+
+private:
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> words[WORDS];
+};
+
+#endif // SEQLOCK_H
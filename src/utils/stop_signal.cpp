@@ -0,0 +1,67 @@
+#include "stop_signal.hpp"
+#include "logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+StopSignal::StopSignal() : stopped(false), notified(false), eventFd(NO_FD) {}
+
+StopSignal::~StopSignal() {
+    if (this->eventFd >= 0) close(this->eventFd);
+}
+
+void StopSignal::requestStop() {
+    int signalFd = NO_FD;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->stopped.exchange(true)) return;
+        signalFd = this->eventFd;
+    }
+    this->cv.notify_all();
+    // Sem eventfd criado não há poll() a acordar; um fd() posterior já nasce legível
+    if (signalFd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(signalFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+bool StopSignal::stopRequested() const {
+    return this->stopped.load(std::memory_order_acquire);
+}
+
+void StopSignal::notify() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->notified = true;
+    }
+    this->cv.notify_all();
+}
+
+StopSignal::Wake StopSignal::waitUntil(std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->cv.wait_until(lock, deadline, [this]() { return this->stopped.load() || this->notified; });
+    if (this->stopped.load()) return Wake::STOPPED;
+    if (this->notified) {
+        this->notified = false;
+        return Wake::NOTIFIED;
+    }
+    return Wake::TIMEOUT;
+}
+
+StopSignal::Wake StopSignal::waitFor(std::chrono::steady_clock::duration timeout) {
+    return this->waitUntil(std::chrono::steady_clock::now() + timeout);
+}
+
+int StopSignal::fd() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->eventFd != NO_FD) return this->eventFd;
+    this->eventFd = eventfd(this->stopped.load() ? 1 : 0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (this->eventFd < 0) {
+        Logger::log(LogLevel::STARTUP, "[ERROR] StopSignal - eventfd falhou: " + std::string(strerror(errno)));
+        this->eventFd = -1;
+    }
+    return this->eventFd;
+}
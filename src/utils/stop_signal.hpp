@@ -0,0 +1,56 @@
+#ifndef STOP_SIGNAL_H
+#define STOP_SIGNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Sinal de parada/despertar compartilhado pelos laços das threads de trabalho.
+//
+// Em vez de sleep_for seguido de uma checagem de flag, os laços esperam no
+// sinal com um prazo: requestStop() acorda todas as esperas imediatamente, e
+// notify() acorda o consumidor para aplicar uma mudança de controle sem
+// esperar o próximo período. Para laços baseados em poll() (terminal,
+// signalfd), fd() é um eventfd que fica legível quando a parada é pedida.
+// O eventfd só é criado na primeira chamada a fd(): cada Hidrometer tem o seu
+// sinal e quase nenhum é observado por poll(), então milhares de hidrômetros
+// não consomem descritores.
+class StopSignal {
+public:
+    enum class Wake {
+        TIMEOUT,    // prazo atingido
+        NOTIFIED,   // notify() desde a última espera
+        STOPPED     // requestStop()
+    };
+
+    StopSignal();
+    ~StopSignal();
+
+    StopSignal(const StopSignal&) = delete;
+    StopSignal& operator=(const StopSignal&) = delete;
+
+    void requestStop();
+    bool stopRequested() const;
+
+    // Acorda uma espera pendente (ou a próxima) sem pedir parada
+    void notify();
+
+    Wake waitUntil(std::chrono::steady_clock::time_point deadline);
+    Wake waitFor(std::chrono::steady_clock::duration timeout);
+
+    // Cria o eventfd na primeira chamada (já legível se a parada foi pedida);
+    // -1 se eventfd falhou
+    int fd() const;
+
+private:
+    static constexpr int NO_FD = -2;   // eventfd ainda não criado
+
+    std::atomic<bool> stopped;
+    bool notified;
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    mutable int eventFd;
+};
+
+#endif // STOP_SIGNAL_H
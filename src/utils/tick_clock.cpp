@@ -0,0 +1,91 @@
+#include "tick_clock.hpp"
+#include <algorithm>
+
+const uint32_t TickHistogram::UPPER_US[TickHistogram::BUCKETS - 1] = {
+    10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 1000000
+};
+
+void TickHistogram::merge(const TickHistogram& other) {
+    for (size_t b = 0; b < BUCKETS; ++b) this->counts[b] += other.counts[b];
+    this->ticks += other.ticks;
+    this->overruns += other.overruns;
+    this->sumLatenessUs += other.sumLatenessUs;
+    if (other.maxLatenessUs > this->maxLatenessUs) this->maxLatenessUs = other.maxLatenessUs;
+}
+
+uint64_t TickHistogram::percentileUs(double q) const {
+    uint64_t total = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) total += this->counts[b];
+    if (total == 0) return 0;
+
+    uint64_t target = static_cast<uint64_t>(q * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b + 1 < BUCKETS; ++b) {
+        seen += this->counts[b];
+        if (seen >= target) return std::min<uint64_t>(UPPER_US[b], this->maxLatenessUs);
+    }
+    return this->maxLatenessUs;
+}
+
+std::string TickHistogram::bucketLabel(size_t bucket) {
+    auto format = [](uint32_t us) {
+        return us >= 1000 ? std::to_string(us / 1000) + "ms" : std::to_string(us) + "us";
+    };
+    if (bucket == 0) return "<" + format(UPPER_US[0]);
+    if (bucket + 1 == BUCKETS) return ">=" + format(UPPER_US[BUCKETS - 2]);
+    return format(UPPER_US[bucket - 1]) + "-" + format(UPPER_US[bucket]);
+}
+
+TickClock::TickClock(Clock::duration period)
+    : period(period),
+      ticks(0),
+      overruns(0),
+      maxLatenessUs(0),
+      sumLatenessUs(0)
+{
+    for (size_t b = 0; b < TickHistogram::BUCKETS; ++b) this->counts[b].store(0, std::memory_order_relaxed);
+    this->start();
+}
+
+void TickClock::start(Clock::time_point now) {
+    this->last = now;
+    this->next = now + this->period;
+}
+
+TickClock::Clock::time_point TickClock::deadline() const { return this->next; }
+TickClock::Clock::duration TickClock::getPeriod() const { return this->period; }
+
+double TickClock::tick(Clock::time_point now) {
+    Clock::duration late = now > this->next ? now - this->next : Clock::duration::zero();
+    uint64_t lateUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(late).count());
+
+    size_t bucket = 0;
+    while (bucket + 1 < TickHistogram::BUCKETS && lateUs >= TickHistogram::UPPER_US[bucket]) ++bucket;
+    this->counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    this->ticks.fetch_add(1, std::memory_order_relaxed);
+    this->sumLatenessUs.fetch_add(lateUs, std::memory_order_relaxed);
+    if (lateUs > this->maxLatenessUs.load(std::memory_order_relaxed)) {
+        this->maxLatenessUs.store(lateUs, std::memory_order_relaxed);
+    }
+
+    // Próximo prazo na grade absoluta; prazos já vencidos são pulados
+    this->next += this->period;
+    if (now >= this->next) {
+        this->next += ((now - this->next) / this->period + 1) * this->period;
+        this->overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    double dt = std::chrono::duration<double>(now - this->last).count();
+    this->last = now;
+    return dt;
+}
+
+TickHistogram TickClock::getHistogram() const {
+    TickHistogram h;
+    for (size_t b = 0; b < TickHistogram::BUCKETS; ++b) h.counts[b] = this->counts[b].load(std::memory_order_relaxed);
+    h.ticks = this->ticks.load(std::memory_order_relaxed);
+    h.overruns = this->overruns.load(std::memory_order_relaxed);
+    h.maxLatenessUs = this->maxLatenessUs.load(std::memory_order_relaxed);
+    h.sumLatenessUs = this->sumLatenessUs.load(std::memory_order_relaxed);
+    return h;
+}
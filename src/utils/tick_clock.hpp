@@ -0,0 +1,63 @@
+#ifndef TICK_CLOCK_H
+#define TICK_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Histograma do atraso de cada tick em relação ao seu prazo absoluto.
+// Faixas: [0,10µs) [10µs,20µs) [20µs,50µs) ... [100ms,1s) [1s,inf)
+struct TickHistogram {
+    static constexpr size_t BUCKETS = 15;
+    static const uint32_t UPPER_US[BUCKETS - 1];
+
+    uint64_t counts[BUCKETS] = {};
+    uint64_t ticks = 0;
+    uint64_t overruns = 0;          // ticks que perderam ao menos um prazo inteiro
+    uint64_t maxLatenessUs = 0;
+    uint64_t sumLatenessUs = 0;
+
+    void merge(const TickHistogram& other);
+    // Limite superior da faixa que contém o quantil q (µs, no máximo o maior atraso)
+    uint64_t percentileUs(double q) const;
+    static std::string bucketLabel(size_t bucket);
+};
+
+// Relógio de tick periódico sem deriva: os prazos são absolutos
+// (início + k * período), então o tempo gasto no trabalho e o atraso do
+// escalonador não se acumulam. Cada tick devolve o dt medido desde o tick
+// anterior para que a integração use o tempo real decorrido. Prazos perdidos
+// por inteiro são pulados (overrun) em vez de disparar ticks em rajada.
+//
+// Um único thread chama start()/tick(); getHistogram() pode ser chamado de
+// qualquer thread.
+class TickClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TickClock(Clock::duration period);
+
+    void start(Clock::time_point now = Clock::now());
+    Clock::time_point deadline() const;
+
+    // Registra o tick que acordou em now e avança o prazo; devolve dt (s)
+    double tick(Clock::time_point now = Clock::now());
+
+    Clock::duration getPeriod() const;
+    TickHistogram getHistogram() const;
+
+private:
+    Clock::duration period;
+    Clock::time_point next;
+    Clock::time_point last;
+
+    std::atomic<uint64_t> counts[TickHistogram::BUCKETS];
+    std::atomic<uint64_t> ticks;
+    std::atomic<uint64_t> overruns;
+    std::atomic<uint64_t> maxLatenessUs;
+    std::atomic<uint64_t> sumLatenessUs;
+};
+
+#endif // TICK_CLOCK_H
@@ -0,0 +1,240 @@
+// Verificações de regressão do coletor de leituras (make check): ida e volta
+// do formato binário de lote, coleta completa contra o HeadEndServer e
+// término do CollectionEmulator quando o head-end derruba uma das conexões
+// no meio da coleta.
+#include "../src/modules/collection.hpp"
+#include "../src/utils/logger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char* CHECK_SOCKET = "/tmp/hydrometer_collection_check.sock";
+
+int failures = 0;
+
+void expect(bool condition, const char* what) {
+    printf("  [%s] %s\n", condition ? "ok" : "FALHOU", what);
+    if (!condition) ++failures;
+}
+
+// Lote codificado e decodificado de volta com a mesma soma de verificação
+void checkRoundTrip() {
+    printf("ReadingBatchEncoder/decodeReadingBatch\n");
+    struct Reading {
+        uint32_t meter;
+        int32_t counter;
+        bool active;
+    };
+    // Ids com saltos (1 e vários bytes de varint), contadores nos extremos
+    const std::vector<Reading> readings = {
+        {7, 0, true},           {8, 1, false},         {9, 127, true},          {200, 128, true},
+        {201, 16383, false},    {70000, 16384, true},  {70001, 2147483647, true}, {4000000000u, -1, false},
+        {4000000001u, -2147483647 - 1, true},
+    };
+
+    ReadingBatchEncoder encoder;
+    encoder.begin(42, 3, 5, 99, READING_BATCH_RETRY);
+    uint64_t expected = 0;
+    for (const Reading& r : readings) {
+        encoder.add(r.meter, r.counter, r.active);
+        expected += readingChecksum(r.meter, r.counter, r.active);
+    }
+    const std::string batch = encoder.finish();
+
+    ReadingBatchHeader header;
+    std::memcpy(&header, batch.data(), sizeof(header));
+    const uint8_t* payload = reinterpret_cast<const uint8_t*>(batch.data()) + sizeof(header);
+    expect(header.magic == READING_BATCH_MAGIC && header.version == READING_BATCH_VERSION, "cabeçalho: magic e versão");
+    expect(header.sequence == 42 && header.route == 3 && header.cycle == 5 && header.snapshotEpoch == 99 &&
+               header.flags == READING_BATCH_RETRY,
+           "cabeçalho: sequência, rota, ciclo, epoch e flags");
+    expect(header.count == readings.size() && header.baseId == readings.front().meter &&
+               header.payloadBytes == batch.size() - sizeof(header),
+           "cabeçalho: contagem, primeiro id e tamanho do payload");
+
+    uint64_t checksum = 0;
+    expect(decodeReadingBatch(header, payload, checksum) && checksum == expected, "ida e volta com a mesma soma");
+
+    ReadingBatchHeader truncated = header;
+    --truncated.payloadBytes;
+    checksum = 0;
+    expect(!decodeReadingBatch(truncated, payload, checksum) && checksum == 0, "payload truncado é recusado");
+
+    ReadingBatchHeader extra = header;
+    --extra.count;
+    expect(!decodeReadingBatch(extra, payload, checksum), "bytes além de count são recusados");
+
+    encoder.begin(43, 0, 0, 0, 0);
+    const std::string empty = encoder.finish();
+    std::memcpy(&header, empty.data(), sizeof(header));
+    checksum = 0;
+    expect(header.count == 0 && empty.size() == sizeof(header) &&
+               decodeReadingBatch(header, reinterpret_cast<const uint8_t*>(empty.data()) + sizeof(header), checksum),
+           "lote vazio");
+}
+
+// Coleta completa contra o head-end de verdade: várias conexões abertas ao
+// mesmo tempo, novas tentativas, e as somas dos dois lados batendo
+void checkHeadEnd() {
+    printf("CollectionEmulator contra o HeadEndServer\n");
+    StandardFleet fleet;
+    for (uint32_t i = 0; i < 50000; ++i) fleet.add(i % StandardFleet::MODEL_COUNT, static_cast<int32_t>(i * 7), i % 5 != 0);
+    SnapshotPublisher publisher;
+    publisher.publish(fleet, 0);
+
+    HeadEndServer headEnd;
+    if (!headEnd.start(CHECK_SOCKET)) {
+        expect(false, "HeadEndServer iniciado");
+        return;
+    }
+
+    CollectionConfig config;
+    config.socketPath = CHECK_SOCKET;
+    config.routes = 16;
+    config.cycles = 3;
+    config.cyclePeriodMs = 0;
+    config.batchSize = 1024;
+    config.responseRate = 0.9f;
+    config.retryDelayMs = 5;
+    config.threads = 4;
+
+    CollectionEmulator emulator(config, publisher);
+    bool ok = emulator.run();
+    headEnd.stop();
+    const CollectionStats& stats = emulator.getStats();
+    const HeadEndStats server = headEnd.getStats();
+    expect(ok, "run() conclui sem falhas");
+    expect(server.connections == config.threads, "uma conexão por thread de coleta");
+    expect(stats.routeCycles == config.routes * config.cycles, "todos os ciclos de rota atendidos");
+    expect(stats.readings == server.readings && stats.readings + stats.missing == 50000ull * config.cycles,
+           "leituras confirmadas + sem resposta = frota × ciclos");
+    expect(stats.retries > 0 && server.retryBatches > 0, "novas tentativas enviadas");
+    expect(server.malformed == 0 && stats.rejected == 0, "nenhum lote recusado");
+    expect(stats.checksum == server.checksum, "soma do coletor igual à do head-end");
+}
+
+bool readAll(int fd, void* data, size_t length) {
+    uint8_t* p = static_cast<uint8_t*>(data);
+    while (length > 0) {
+        ssize_t n = read(fd, p, length);
+        if (n <= 0) return false;
+        p += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Head-end de teste: a primeira conexão aceita é fechada ao receber o
+// primeiro lote; as demais confirmam cada lote com atraso, para que o outro
+// trabalhador esteja no meio de uma tarefa quando a falha acontece
+class FlakyHeadEnd {
+public:
+    bool start(const char* path) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+        this->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        unlink(path);
+        if (this->listenFd < 0 || bind(this->listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(this->listenFd, 8) != 0) {
+            return false;
+        }
+        this->acceptThread = std::thread([this]() {
+            for (int index = 0;; ++index) {
+                int fd = accept(this->listenFd, nullptr, nullptr);
+                if (fd < 0) return;
+                this->clients.emplace_back([this, fd, index]() { this->serve(fd, index == 0); });
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        shutdown(this->listenFd, SHUT_RDWR);
+        close(this->listenFd);
+        if (this->acceptThread.joinable()) this->acceptThread.join();
+        for (std::thread& t : this->clients) t.join();
+    }
+
+private:
+    void serve(int fd, bool drop) {
+        ReadingBatchHeader header;
+        std::vector<uint8_t> payload;
+        while (readAll(fd, &header, sizeof(header))) {
+            payload.resize(header.payloadBytes);
+            if (!readAll(fd, payload.data(), payload.size()) || drop) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            ReadingAck ack{READING_ACK_MAGIC, header.sequence, header.count, 0};
+            if (write(fd, &ack, sizeof(ack)) != static_cast<ssize_t>(sizeof(ack))) break;
+        }
+        close(fd);
+    }
+
+    int listenFd = -1;
+    std::thread acceptThread;
+    std::vector<std::thread> clients;
+};
+
+// Uma conexão perdida com outra ainda em uso: run() deve retornar false
+// logo, sem esperar para sempre por ciclos que ninguém mais vai atender
+void checkConnectionLoss() {
+    printf("CollectionEmulator com uma conexão perdida\n");
+    StandardFleet fleet;
+    for (uint32_t i = 0; i < 4000; ++i) fleet.add(i % StandardFleet::MODEL_COUNT, static_cast<int32_t>(i), true);
+    SnapshotPublisher publisher;
+    publisher.publish(fleet, 0);
+
+    FlakyHeadEnd headEnd;
+    if (!headEnd.start(CHECK_SOCKET)) {
+        expect(false, "head-end de teste iniciado");
+        return;
+    }
+
+    CollectionConfig config;
+    config.socketPath = CHECK_SOCKET;
+    config.routes = 8;
+    config.cycles = 2;
+    config.cyclePeriodMs = 0;
+    config.batchSize = 256;
+    config.window = 1;
+    config.responseRate = 1.0f;
+    config.threads = 2;
+
+    CollectionEmulator emulator(config, publisher);
+    std::future<bool> result = std::async(std::launch::async, [&emulator]() { return emulator.run(); });
+    if (result.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+        expect(false, "run() termina após a perda da conexão");
+        printf("%d verificação(ões) falharam\n", failures);
+        fflush(stdout);
+        _exit(1);   // a thread presa em run() não pode ser unida
+    }
+    expect(true, "run() termina após a perda da conexão");
+    expect(!result.get(), "run() relata a falha");
+    headEnd.stop();
+    unlink(CHECK_SOCKET);
+}
+
+} // namespace
+
+int main() {
+    Logger::setDebugMode(false);
+    checkRoundTrip();
+    checkHeadEnd();
+    checkConnectionLoss();
+    if (failures > 0) {
+        printf("%d verificação(ões) falharam\n", failures);
+        return 1;
+    }
+    printf("todas as verificações passaram\n");
+    return 0;
+}
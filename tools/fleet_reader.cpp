@@ -0,0 +1,40 @@
+// Leitor externo de exemplo: mapeia o segmento publicado pelo simulador
+// (--shm) e imprime snapshots consistentes de cada hidrômetro.
+#include "../src/modules/shared_fleet.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+    std::string name = SHARED_FLEET_DEFAULT_NAME;
+    bool watch = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--watch")) watch = true;
+        else name = argv[i];
+    }
+
+    SharedFleetReader reader;
+    if (!reader.open(name)) {
+        fprintf(stderr, "[ERROR] Segmento %s indisponível ou com layout incompatível\n", name.c_str());
+        return 1;
+    }
+
+    do {
+        printf("geração %llu, %u hidrômetros, estado %u\n",
+               static_cast<unsigned long long>(reader.getGeneration()), reader.getMeterCount(),
+               static_cast<unsigned>(reader.getState()));
+        for (uint32_t i = 0; i < reader.getMeterCount(); ++i) {
+            SharedMeterRecord r;
+            uint32_t version = 0;
+            reader.read(i, r, &version);
+            printf("  [%u] %-7s IN %8.4f m³/h  OUT %8.4f m³/h  contador %8.3f m³  (v%u)\n",
+                   r.id, r.status ? "ATIVO" : "INATIVO", r.flowIN * 3600.0f, r.flowOUT * 3600.0f,
+                   r.counter / 1000.0f, version);
+        }
+        if (watch) std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    } while (watch && reader.getState() == SharedFleetState::ACTIVE);
+
+    return 0;
+}